@@ -0,0 +1,60 @@
+#include <algorithm>
+
+#include "animation.hpp"
+
+float orientationAngle(Orientation orient)
+{
+    switch (orient)
+    {
+        case Orientation::UP:
+            return 180.0f;
+        case Orientation::DOWN:
+            return 0.0f;
+        case Orientation::LEFT:
+            return 90.0f;
+        case Orientation::RIGHT:
+            return -90.0f;
+    }
+    return 0.0f;
+}
+
+float turnAngle(Orientation from, Orientation to)
+{
+    float angle{orientationAngle(to) - orientationAngle(from)};
+    if (angle <= -180.0f)
+        angle += 360.0f;
+    else if (angle > 180.0f)
+        angle -= 360.0f;
+    return angle == -180.0f ? 180.0f : angle;
+}
+
+double Action::turnDuration() const
+{
+    return this->from.orient == this->to.orient ? 0.0 : TURN_DURATION;
+}
+
+double Action::duration() const
+{
+    return this->turnDuration() + (this->type == EventType::MOVE ? MOVE_DURATION : 0.0);
+}
+
+Pose Action::poseAt(double t) const
+{
+    if (this->reversed)
+        t = this->duration() - t;
+    double turnDuration{this->turnDuration()};
+    float turnPhase{turnDuration > 0.0 ? static_cast<float>(std::clamp(t / turnDuration, 0.0, 1.0)) : 1.0f};
+    float movePhase{this->type == EventType::MOVE ? static_cast<float>(std::clamp((t - turnDuration) / MOVE_DURATION, 0.0, 1.0)) : 0.0f};
+    float fromX{static_cast<float>(this->from.x)};
+    float fromY{static_cast<float>(this->from.y)};
+    return Pose{
+        fromX + (static_cast<float>(this->to.x) - fromX)*movePhase,
+        fromY + (static_cast<float>(this->to.y) - fromY)*movePhase,
+        orientationAngle(this->from.orient) + turnAngle(this->from.orient, this->to.orient)*turnPhase
+    };
+}
+
+const RobotState& Action::end() const
+{
+    return this->reversed ? this->from : this->to;
+}
@@ -0,0 +1,48 @@
+#ifndef ANIMATION_H
+#define ANIMATION_H
+
+#include "orientation.hpp"
+#include "episode.hpp"
+#include "simulation.hpp"
+
+// animation clock advances in fixed steps, independent of the frame rate
+inline constexpr double SIMULATION_TIMESTEP{1.0 / 120.0};
+// longest frame fed to the clock, a stall (window drag, breakpoint) doesn't fast forward the replay
+inline constexpr double MAX_FRAME_TIME{0.25};
+// seconds to drive one cell and to make any turn, the speed the viewer always had at 60 fps
+inline constexpr double MOVE_DURATION{10.0 / 60.0};
+inline constexpr double TURN_DURATION{9.0 / 60.0};
+
+// where a robot is drawn: cell coordinates and heading in degrees, turning right from DOWN
+struct Pose
+{
+    float x;
+    float y;
+    float angle;
+};
+
+float orientationAngle(Orientation orient);
+// signed angle of the shortest turn between two orientations, half turns go right
+float turnAngle(Orientation from, Orientation to);
+
+// one robot animating one event: turn to the new orientation, then drive to the new cell
+struct Action
+{
+    unsigned int robot;
+    EventType type;
+    RobotState from;
+    RobotState to;
+    // animation clock time the action started at
+    double start{0.0};
+    // played backwards, from to back to from
+    bool reversed{false};
+
+    double turnDuration() const;
+    double duration() const;
+    // pose t seconds after the action started
+    Pose poseAt(double t) const;
+    // where the robot stands once the action is over
+    const RobotState& end() const;
+};
+
+#endif
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "episode.hpp"
+
+// seconds spent in f, best of repeats
+template <typename F>
+double bestOf(unsigned int repeats, F f)
+{
+    double best{1e30};
+    for (unsigned int i=0; i<repeats; ++i)
+    {
+        auto start{std::chrono::steady_clock::now()};
+        f();
+        std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+        if (elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+void benchParse(const std::string& logFile, unsigned int repeats)
+{
+    std::ifstream file(logFile, std::ios::binary | std::ios::ate);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open file.\n";
+        exit(1);
+    }
+    double megabytes{static_cast<double>(file.tellg()) / (1024.0*1024.0)};
+    file.close();
+    // baseline: just pull the bytes through, nothing parsed
+    double readTime{bestOf(repeats, [&]() {
+        std::ifstream in(logFile, std::ios::binary);
+        std::vector<char> chunk(1 << 20);
+        while (in.read(chunk.data(), chunk.size()) || in.gcount() > 0);
+    })};
+    std::size_t numEvents{0};
+    double parseTime{bestOf(repeats, [&]() {
+        numEvents = loadEpisode(logFile).events.size();
+    })};
+    std::cout << "log size:  " << megabytes << " MB, " << numEvents << " events\n";
+    std::cout << "read:      " << megabytes / readTime << " MB/s\n";
+    std::cout << "parse:     " << megabytes / parseTime << " MB/s (" << numEvents / parseTime / 1e6 << " M events/s)\n";
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <log file> [repeats]\n";
+        return 1;
+    }
+    unsigned int repeats{argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : 5u};
+    benchParse(argv[1], repeats);
+    return 0;
+}
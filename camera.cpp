@@ -0,0 +1,75 @@
+#include <utility>
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+
+#include "camera.hpp"
+
+Camera::Camera(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix)
+: _block{projectionMatrix, viewMatrix}
+, _changed{true}
+{
+    glGenBuffers(1, &this->_buffer);
+    glBindBuffer(GL_UNIFORM_BUFFER, this->_buffer);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
+
+Camera::~Camera()
+{
+    if (this->_buffer != 0)
+        glDeleteBuffers(1, &this->_buffer);
+}
+
+Camera::Camera(Camera&& camera) noexcept
+: _block{camera._block}
+, _buffer{std::exchange(camera._buffer, 0)}
+, _changed{camera._changed}
+{
+}
+
+Camera& Camera::operator=(Camera&& camera) noexcept
+{
+    if (this != &camera)
+    {
+        if (this->_buffer != 0)
+            glDeleteBuffers(1, &this->_buffer);
+        this->_block = camera._block;
+        this->_buffer = std::exchange(camera._buffer, 0);
+        this->_changed = camera._changed;
+    }
+    return *this;
+}
+
+const glm::mat4& Camera::projectionMatrix() const
+{
+    return this->_block.projection;
+}
+
+void Camera::setProjectionMatrix(const glm::mat4& projectionMatrix)
+{
+    this->_block.projection = projectionMatrix;
+    this->_changed = true;
+}
+
+const glm::mat4& Camera::viewMatrix() const
+{
+    return this->_block.view;
+}
+
+void Camera::setViewMatrix(const glm::mat4& viewMatrix)
+{
+    this->_block.view = viewMatrix;
+    this->_changed = true;
+}
+
+void Camera::bind()
+{
+    if (this->_changed)
+    {
+        glBindBuffer(GL_UNIFORM_BUFFER, this->_buffer);
+        glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(CameraBlock), &this->_block);
+        glBindBuffer(GL_UNIFORM_BUFFER, 0);
+        this->_changed = false;
+    }
+    glBindBufferBase(GL_UNIFORM_BUFFER, CAMERA_BINDING, this->_buffer);
+}
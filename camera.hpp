@@ -0,0 +1,41 @@
+#ifndef CAMERA_H
+#define CAMERA_H
+#include <glm/glm.hpp>
+
+// uniform buffer binding of the Camera block every vertex shader reads
+inline constexpr unsigned int CAMERA_BINDING{0};
+
+// the Camera block as std140 lays it out
+struct CameraBlock
+{
+    glm::mat4 projection;
+    glm::mat4 view;
+};
+
+static_assert(sizeof(CameraBlock) == 128);
+
+// projection and view shared by every shader through one uniform buffer, models only keep their own matrix
+class Camera
+{
+public:
+    Camera() = default;
+    Camera(const glm::mat4& projectionMatrix, const glm::mat4& viewMatrix);
+    // deletes the uniform buffer, which only ever has one owner
+    ~Camera();
+    Camera(const Camera&) = delete;
+    Camera& operator=(const Camera&) = delete;
+    Camera(Camera&& camera) noexcept;
+    Camera& operator=(Camera&& camera) noexcept;
+    const glm::mat4& projectionMatrix() const;
+    void setProjectionMatrix(const glm::mat4& projectionMatrix);
+    const glm::mat4& viewMatrix() const;
+    void setViewMatrix(const glm::mat4& viewMatrix);
+    // upload the block if it changed and bind it at CAMERA_BINDING, once per frame before drawing
+    void bind();
+private:
+    CameraBlock _block;
+    unsigned int _buffer{0};
+    bool _changed{false};
+};
+
+#endif
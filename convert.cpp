@@ -0,0 +1,47 @@
+#include <iostream>
+#include <string>
+#include <sys/stat.h>
+
+#include "episode.hpp"
+#include "replay.hpp"
+
+long fileSize(const std::string& path)
+{
+    struct stat info;
+    return stat(path.c_str(), &info) == 0 ? static_cast<long>(info.st_size) : 0;
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <log file> [replay file] [--board-size <n>]\n";
+        return 1;
+    }
+    std::string logFile{argv[1]};
+    std::string replayFile{logFile.substr(0, logFile.find_last_of('.')) + ".rbr"};
+    // 0 infers it from the log
+    unsigned int boardSize{0};
+    for (int i=2; i<argc; ++i)
+    {
+        std::string arg{argv[i]};
+        if (arg == "--board-size" && i+1 < argc)
+        {
+            unsigned long size{std::stoul(argv[++i])};
+            if (size == 0 || size > MAX_BOARD_SIZE)
+            {
+                std::cerr << "Board size must be 1 to " << MAX_BOARD_SIZE << ".\n";
+                return 1;
+            }
+            boardSize = static_cast<unsigned int>(size);
+        }
+        else
+            replayFile = arg;
+    }
+    Episode episode{loadEpisode(logFile, boardSize)};
+    saveReplay(episode, replayFile);
+    std::cout << logFile << " (" << fileSize(logFile) << " bytes) -> "
+              << replayFile << " (" << fileSize(replayFile) << " bytes), "
+              << episode.events.size() << " events\n";
+    return 0;
+}
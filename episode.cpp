@@ -0,0 +1,182 @@
+#include <iostream>
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "episode.hpp"
+#include "mappedfile.hpp"
+#include "replay.hpp"
+
+namespace
+{
+
+bool consume(std::string_view& text, std::string_view token)
+{
+    if (text.substr(0, token.size()) != token)
+        return false;
+    text.remove_prefix(token.size());
+    return true;
+}
+
+void skipSpaces(std::string_view& text)
+{
+    while (!text.empty() && text.front() == ' ')
+        text.remove_prefix(1);
+}
+
+bool consumeUnsigned(std::string_view& text, unsigned int& value)
+{
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc{})
+        return false;
+    text.remove_prefix(end - text.data());
+    return true;
+}
+
+// cells off the largest board are rejected like any other garbage
+bool consumeCell(std::string_view& text, std::string_view open, std::string_view close, unsigned int& x, unsigned int& y)
+{
+    return consume(text, open)
+        && consumeUnsigned(text, x)
+        && consume(text, ",")
+        && consumeUnsigned(text, y)
+        && consume(text, close)
+        && x < MAX_BOARD_SIZE
+        && y < MAX_BOARD_SIZE;
+}
+
+bool consumeDirection(std::string_view& text, Orientation& direction)
+{
+    if (consume(text, "up")) direction = Orientation::UP;
+    else if (consume(text, "down")) direction = Orientation::DOWN;
+    else if (consume(text, "left")) direction = Orientation::LEFT;
+    else if (consume(text, "right")) direction = Orientation::RIGHT;
+    else return false;
+    return true;
+}
+
+}
+
+LineKind parseLogLine(std::string_view line, Episode& episode)
+{
+    // every line looks like "INFO: At t=<tick> <message>", other prefixes are searched for
+    if (!consume(line, "INFO: At t="))
+    {
+        std::size_t at{line.find("t=")};
+        if (at == std::string_view::npos)
+            return LineKind::NONE;
+        line.remove_prefix(at + 2);
+    }
+    unsigned int tick;
+    if (!consumeUnsigned(line, tick))
+        return LineKind::NONE;
+    skipSpaces(line);
+    if (consume(line, "Player "))
+    {
+        // the winner is written in lower case
+        if (line.empty())
+            return LineKind::NONE;
+        std::size_t player{episode.players.find(static_cast<char>(std::toupper(line.front())))};
+        line.remove_prefix(1);
+        if (player == std::string_view::npos || !consume(line, " win"))
+            return LineKind::NONE;
+        episode.events.push_back(Event{tick, static_cast<std::uint16_t>(player), EventType::WIN, Orientation::DOWN, 0, 0, 0});
+        return LineKind::EVENT;
+    }
+    if (consume(line, "game starts with "))
+    {
+        unsigned int numRobotsPerPlayer, numPlayers;
+        if (!consumeUnsigned(line, numRobotsPerPlayer)
+            || !consume(line, " number robots per player and ")
+            || !consumeUnsigned(line, numPlayers))
+            return LineKind::NONE;
+        episode.numRobotsPerPlayer = numRobotsPerPlayer;
+        episode.numPlayers = numPlayers;
+        episode.initialPositions.resize(numRobotsPerPlayer*numPlayers);
+        episode.lastPositions.resize(numRobotsPerPlayer*numPlayers);
+        return LineKind::HEADER;
+    }
+    // robot lines need the header to compute the robot index
+    if (line.empty() || episode.numRobotsPerPlayer == 0)
+        return LineKind::NONE;
+    std::size_t player{episode.players.find(line.front())};
+    // games with more players than PLAYERS use other letters, numbered as they first show up
+    if (player == std::string_view::npos && std::isupper(static_cast<unsigned char>(line.front())) && episode.players.size() < episode.numPlayers)
+    {
+        player = episode.players.size();
+        episode.players.push_back(line.front());
+    }
+    line.remove_prefix(1);
+    unsigned int number;
+    if (player == std::string_view::npos || !consume(line, " robot ") || !consumeUnsigned(line, number))
+        return LineKind::NONE;
+    if (number == 0 || number > episode.numRobotsPerPlayer)
+        return LineKind::NONE;
+    unsigned int robot = episode.numRobotsPerPlayer*player + number - 1;
+    if (robot >= episode.initialPositions.size())
+        return LineKind::NONE;
+    unsigned int x, y;
+    if (consume(line, " in position "))
+    {
+        if (!consumeCell(line, "[", "]", x, y))
+            return LineKind::NONE;
+        episode.initialPositions[robot] = RobotPosition{static_cast<unsigned int>(player), x, y};
+        episode.lastPositions[robot] = episode.initialPositions[robot];
+        episode.boardSize = std::max({episode.boardSize, x + 1, y + 1});
+        return LineKind::POSITION;
+    }
+    if (consume(line, " go "))
+    {
+        Orientation direction;
+        if (!consumeDirection(line, direction) || !consume(line, " to position ") || !consumeCell(line, "(", ")", x, y))
+            return LineKind::NONE;
+        episode.events.push_back(Event{tick, static_cast<std::uint16_t>(robot), EventType::MOVE, direction,
+            static_cast<std::uint16_t>(x), static_cast<std::uint16_t>(y), 0});
+        episode.lastPositions[robot].x = x;
+        episode.lastPositions[robot].y = y;
+        episode.boardSize = std::max({episode.boardSize, x + 1, y + 1});
+        return LineKind::EVENT;
+    }
+    EventType type;
+    if (consume(line, " pick up mail "))
+        type = EventType::PICKUP;
+    else if (consume(line, " drop off mail "))
+        type = EventType::DROPOFF;
+    else
+        return LineKind::NONE;
+    unsigned int mail;
+    if (!consumeUnsigned(line, mail))
+        return LineKind::NONE;
+    // mail is only picked up on the pickup row, the second to last one
+    if (type == EventType::PICKUP)
+        episode.boardSize = std::max(episode.boardSize, std::min(episode.lastPositions[robot].y + 2, MAX_BOARD_SIZE));
+    episode.events.push_back(Event{tick, static_cast<std::uint16_t>(robot), type, Orientation::DOWN, 0, 0, static_cast<std::uint16_t>(mail)});
+    return LineKind::EVENT;
+}
+
+Episode parseLogFile(const std::string& logFile, unsigned int boardSize)
+{
+    MappedFile file(logFile);
+    if (!file.isOpen())
+    {
+        std::cerr << "Failed to open file.\n";
+        exit(1);
+    }
+    Episode episode;
+    if (boardSize > 0)
+        episode.boardSize = boardSize;
+    forEachLine(file.data(), [&episode](std::string_view line) {
+        parseLogLine(line, episode);
+    });
+    return episode;
+}
+
+Episode loadEpisode(const std::string& file, unsigned int boardSize)
+{
+    if (isReplayFile(file))
+        return loadReplay(file);
+    return parseLogFile(file, boardSize);
+}
@@ -0,0 +1,82 @@
+#ifndef EPISODE_H
+#define EPISODE_H
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "orientation.hpp"
+
+// letters of the first players, in the order their robots are numbered
+inline constexpr std::string_view PLAYERS{"RBG"};
+// cells per board side of the standard board, logs don't state it
+inline constexpr unsigned int BOARD_SIZE{9};
+// largest board a log may grow to. a cell beyond it is garbage, not a board worth a square of it
+inline constexpr unsigned int MAX_BOARD_SIZE{1024};
+
+struct RobotPosition
+{
+    // index of player in Episode::players
+    unsigned int player;
+    unsigned int x;
+    unsigned int y;
+};
+
+enum class EventType : std::uint8_t
+{
+    MOVE,
+    PICKUP,
+    DROPOFF,
+    WIN,
+};
+
+// one log line after the header, 16 bytes
+struct Event
+{
+    std::uint32_t tick;
+    // robot index, numRobotsPerPlayer*player + robot number - 1. player index for WIN
+    std::uint16_t robot;
+    EventType type;
+    // MOVE only
+    Orientation direction;
+    // MOVE: target cell
+    std::uint16_t x;
+    std::uint16_t y;
+    // PICKUP and DROPOFF: mail id
+    std::uint16_t mail;
+};
+
+// everything the viewer needs from one log, collected in a single pass
+struct Episode
+{
+    unsigned int numRobotsPerPlayer{0};
+    unsigned int numPlayers{0};
+    // player letters by index: PLAYERS, then other letters in the order they first appear
+    std::string players{PLAYERS};
+    // BOARD_SIZE or the size a log was given, grown to fit every cell a robot starts on or moves to
+    // and to put the pickup row (boardSize - 2) under every pickup
+    unsigned int boardSize{BOARD_SIZE};
+    // indexed by robot index
+    std::vector<RobotPosition> initialPositions;
+    // where each robot was last seen while parsing, its cell at a pickup. replays don't fill it
+    std::vector<RobotPosition> lastPositions;
+    std::vector<Event> events;
+};
+
+// what a log line turned out to be
+enum class LineKind
+{
+    NONE,
+    HEADER,
+    POSITION,
+    EVENT,
+};
+
+// parse one log line into episode, NONE if the line was not recognized
+LineKind parseLogLine(std::string_view line, Episode& episode);
+// boardSize is the size the board grows from, 0 for BOARD_SIZE
+Episode parseLogFile(const std::string& logFile, unsigned int boardSize = 0);
+// load a text log or a .rbr replay. replays keep the board size they were saved with
+Episode loadEpisode(const std::string& file, unsigned int boardSize = 0);
+
+#endif
@@ -0,0 +1,103 @@
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+
+#include "follower.hpp"
+#include "mappedfile.hpp"
+
+LogFollower::LogFollower(const std::string& logFile)
+{
+    this->_fd = open(logFile.c_str(), O_RDONLY);
+    if (this->_fd < 0)
+    {
+        std::cerr << "Failed to open file.\n";
+        exit(1);
+    }
+    this->_inotify = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (this->_inotify < 0 || inotify_add_watch(this->_inotify, logFile.c_str(), IN_MODIFY | IN_CLOSE_WRITE) < 0)
+        std::cerr << "Failed to watch file, falling back to polling.\n";
+}
+
+LogFollower::~LogFollower()
+{
+    if (this->_inotify >= 0)
+        close(this->_inotify);
+    if (this->_fd >= 0)
+        close(this->_fd);
+}
+
+std::size_t LogFollower::poll(Episode& episode)
+{
+    std::size_t numLines{0};
+    char buffer[1 << 16];
+    ssize_t numRead;
+    while ((numRead = read(this->_fd, buffer, sizeof(buffer))) > 0)
+    {
+        const char* begin{buffer};
+        const char* end{buffer + numRead};
+        const char* newline;
+        while ((newline = findNewline(begin, end)) != end)
+        {
+            std::string_view line(begin, newline - begin);
+            begin = newline + 1;
+            if (this->_overlong)
+            {
+                this->_overlong = false;
+                continue;
+            }
+            // finish a line that was cut by the previous read
+            if (!this->_pending.empty())
+            {
+                this->_pending.append(line);
+                line = this->_pending;
+            }
+            switch (parseLogLine(line, episode))
+            {
+                case LineKind::HEADER:
+                    this->_hasHeader = true;
+                    break;
+                case LineKind::POSITION:
+                    ++this->_numPositions;
+                    break;
+                default:
+                    break;
+            }
+            this->_pending.clear();
+            ++numLines;
+        }
+        if (this->_overlong || this->_pending.size() + (end - begin) > MAX_LINE_LENGTH)
+        {
+            this->_pending.clear();
+            this->_overlong = true;
+        }
+        else
+            this->_pending.append(begin, end);
+    }
+    return numLines;
+}
+
+std::size_t LogFollower::wait(Episode& episode, int timeoutMs)
+{
+    if (this->_inotify >= 0)
+    {
+        pollfd watch{this->_inotify, POLLIN, 0};
+        if (::poll(&watch, 1, timeoutMs) > 0)
+        {
+            // drain the notifications, the file itself tells us what changed
+            char events[4096];
+            while (read(this->_inotify, events, sizeof(events)) > 0);
+        }
+    }
+    else
+        usleep(timeoutMs*1000);
+    return this->poll(episode);
+}
+
+bool LogFollower::started(const Episode& episode) const
+{
+    return this->_hasHeader && this->_numPositions >= episode.initialPositions.size();
+}
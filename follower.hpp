@@ -0,0 +1,38 @@
+#ifndef FOLLOWER_H
+#define FOLLOWER_H
+#include <cstddef>
+#include <string>
+
+#include "episode.hpp"
+
+// how long wait() sleeps when nothing is written, keeps the window responsive
+inline constexpr int FOLLOW_TIMEOUT_MS{16};
+// longest line kept while waiting for its newline, longer ones are garbage and dropped whole
+inline constexpr std::size_t MAX_LINE_LENGTH{1 << 16};
+
+// tails a log that is still being written, parsing only the lines appended since the last call
+class LogFollower
+{
+public:
+    explicit LogFollower(const std::string& logFile);
+    ~LogFollower();
+    LogFollower(const LogFollower&) = delete;
+    LogFollower& operator=(const LogFollower&) = delete;
+    // parse complete lines appended since the last call, returns the number of lines parsed
+    std::size_t poll(Episode& episode);
+    // sleep until the log changes or timeoutMs passes, then poll
+    std::size_t wait(Episode& episode, int timeoutMs);
+    // true once the header and every start position have been read
+    bool started(const Episode& episode) const;
+private:
+    int _fd{-1};
+    int _inotify{-1};
+    // tail of the last read that doesn't end with a newline yet, at most MAX_LINE_LENGTH bytes
+    std::string _pending;
+    // skipping the rest of a line longer than MAX_LINE_LENGTH
+    bool _overlong{false};
+    bool _hasHeader{false};
+    std::size_t _numPositions{0};
+};
+
+#endif
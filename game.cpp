@@ -1,375 +1,499 @@
 #include <iostream>
-#include <fstream>
-#include <regex>
 #include <memory>
 #include <vector>
 #include <string>
+#include <thread>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 
 #include "game.hpp"
+#include "follower.hpp"
 
-std::vector<std::pair<unsigned int, Orientation>> prossessLogFile(const std::string& logFile)
+Game::Game(GLFWwindow* window, const std::string& logFile, bool follow, unsigned int boardSize)
+: _follow{follow}
+, _parser{std::make_unique<ParserThread>(logFile, follow, boardSize)}
+, _notexture{setupShader("shaders/notexture.vs", "shaders/notexture.fs")}
+, _withtexture{setupShader("shaders/withtexture.vs", "shaders/withtexture.fs")}
+{
+    // models are imported and decoded on every core while the parser reads the header, held here
+    // until the models below take them over
+    std::vector<std::shared_ptr<const ModelAsset>> assets{loadModelAssets({BOARD_MODEL, FORKLIFT_MODEL, BOX_MODEL})};
+    this->_camera = Camera{PROJECTION, VIEW};
+    this->_board = Board{assets[0], MODEL};
+    // only the header is needed before the first frame, events keep arriving while we play.
+    // a followed log may not have one yet, nothing else handles window events this early
+    while (!this->_parser->waitStarted(FOLLOW_TIMEOUT_MS))
+    {
+        glfwPollEvents();
+        if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        if (glfwWindowShouldClose(window))
+            return;
+    }
+    this->_episode = this->_parser->header();
+    if (!follow)
+        this->_timeline = Timeline{this->_episode};
+    this->_transform = BoardTransform{this->_episode.boardSize};
+    this->_board.setModelMatrix(this->_transform.boardMatrix());
+    this->_setupPalette();
+    this->_setupForklifts();
+    this->_scheduler = ActionScheduler{static_cast<unsigned int>(this->_forklifts.size()), this->_episode.boardSize};
+    this->_boxes = BoxPool{BOX_MODEL, numPickupCells(this->_episode.boardSize) + this->_forklifts.size()};
+    for (unsigned int slot=0; slot<numPickupCells(this->_episode.boardSize); ++slot)
+        this->generateBox(slot);
+    // when following, events written before we started are already applied to the start state
+    this->_state = this->_parser->startState();
+    if (follow)
+        this->_applyState(this->_state);
+    TextureStats textures{textureStats()};
+    std::cout << "Textures: " << textures.live << " loaded, " << textures.hits << " hits, " << textures.misses << " misses" << std::endl;
+}
+
+Game::~Game()
 {
-    std::vector<std::pair<unsigned int, Orientation>> robot_moves;
-    std::ifstream file(logFile);
-    if (!file.is_open())
+    if (this->_palette != 0)
+        glDeleteBuffers(1, &this->_palette);
+}
+
+void Game::_setupForklifts()
+{
+    std::vector<unsigned int> players;
+    for (const RobotPosition& position : this->_episode.initialPositions)
+        players.push_back(position.player);
+    this->_forklifts = ForkliftFleet{FORKLIFT_MODEL, players};
+    for (unsigned int robot=0; robot<this->_forklifts.size(); ++robot)
     {
-        std::cerr << "Failed to open file.\n";
-        exit(1);
+        const RobotPosition& position{this->_episode.initialPositions[robot]};
+        this->_forklifts.setModelMatrix(robot, this->_transform.cellMatrix(position.x, position.y, Orientation::DOWN));
     }
-    std::regex pattern(R"(([RBG]) robot (\d) go (down|right|left|up))");
-    std::string line;
-    std::smatch match;
-    std::getline(file, line);
-    std::regex_search(line, match, std::regex{R"(game starts with (\d) number robots per player)"});
-    int numRobotsPerPlayer{std::stoi(match[1])};
-    while (std::getline(file, line))
+}
+
+std::vector<glm::vec3> playerPalette(unsigned int numPlayers)
+{
+    std::vector<glm::vec3> palette;
+    for (unsigned int player=0; player<numPlayers; ++player)
     {
-        if (std::regex_search(line, match, pattern))
+        if (player < std::size(PLAYER_COLORS))
+        {
+            palette.push_back(PLAYER_COLORS[player]);
+            continue;
+        }
+        // golden angle steps from yellow never land on a hue twice, with the saturation and value of PLAYER_COLORS
+        float hue{std::fmod(60.0f + (player - std::size(PLAYER_COLORS))*137.50776f, 360.0f) / 60.0f};
+        float x{1.0f - std::fabs(std::fmod(hue, 2.0f) - 1.0f)};
+        glm::vec3 color;
+        switch (static_cast<int>(hue))
         {
-            unsigned int index = numRobotsPerPlayer*COLOR2INT.at(match[1]) + std::stoi(match[2]) - 1;
-            if (match[3] == "left") robot_moves.emplace_back(index, Orientation::LEFT);
-            if (match[3] == "right") robot_moves.emplace_back(index, Orientation::RIGHT);
-            if (match[3] == "up") robot_moves.emplace_back(index, Orientation::UP);
-            if (match[3] == "down") robot_moves.emplace_back(index, Orientation::DOWN);
+            case 0: color = glm::vec3(1.0f, x, 0.0f); break;
+            case 1: color = glm::vec3(x, 1.0f, 0.0f); break;
+            case 2: color = glm::vec3(0.0f, 1.0f, x); break;
+            case 3: color = glm::vec3(0.0f, x, 1.0f); break;
+            case 4: color = glm::vec3(x, 0.0f, 1.0f); break;
+            default: color = glm::vec3(1.0f, 0.0f, x); break;
         }
+        palette.push_back(glm::vec3(0.2f) + 0.6f*color);
     }
-    file.close();
-    return robot_moves;
+    return palette;
+}
+
+void Game::_setupPalette()
+{
+    std::vector<glm::vec4> colors;
+    for (const glm::vec3& color : playerPalette(std::max(this->_episode.numPlayers, 1u)))
+        colors.emplace_back(color, 1.0f);
+    glGenBuffers(1, &this->_palette);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->_palette);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, colors.size() * sizeof(glm::vec4), colors.data(), GL_STATIC_DRAW);
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, PALETTE_BINDING, this->_palette);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
+BoardTransform::BoardTransform(unsigned int boardSize)
+: _board{MODEL}
+, _scene{glm::scale(MODEL, glm::vec3(static_cast<float>(BOARD_SIZE) / boardSize))}
+, _center{(static_cast<float>(boardSize) - 1.0f) / 2.0f}
+{
+    this->_orientations[static_cast<int>(Orientation::UP)] = this->_heading(-1.0f, 0.0f);
+    this->_orientations[static_cast<int>(Orientation::DOWN)] = this->_heading(1.0f, 0.0f);
+    this->_orientations[static_cast<int>(Orientation::LEFT)] = this->_heading(0.0f, 1.0f);
+    this->_orientations[static_cast<int>(Orientation::RIGHT)] = this->_heading(0.0f, -1.0f);
+}
 
-Game::Game(const std::string& logFile)
-: _board{"assets/board/board.obj", PROJECTION, VIEW, MODEL}
-, _notexture{setupShader("shaders/notexture.vs", "shaders/notexture.fs")}
-, _withtexture{setupShader("shaders/withtexture.vs", "shaders/withtexture.fs")}
+const glm::mat4& BoardTransform::boardMatrix() const
+{
+    return this->_board;
+}
+
+glm::mat4 BoardTransform::_heading(float cosine, float sine) const
+{
+    glm::mat4 rotation{1.0f};
+    rotation[0] = glm::vec4(cosine, 0.0f, -sine, 0.0f);
+    rotation[2] = glm::vec4(sine, 0.0f, cosine, 0.0f);
+    return this->_scene*rotation;
+}
+
+glm::vec4 BoardTransform::_cellOrigin(float x, float y) const
+{
+    return this->_scene*glm::vec4(this->_center-x, 0.0f, y-this->_center, 1.0f);
+}
+
+glm::mat4 BoardTransform::cellMatrix(unsigned int x, unsigned int y, Orientation orient) const
+{
+    glm::mat4 matrix{this->_orientations[static_cast<int>(orient)]};
+    matrix[3] = this->_cellOrigin(static_cast<float>(x), static_cast<float>(y));
+    return matrix;
+}
+
+glm::mat4 BoardTransform::poseMatrix(const Pose& pose) const
 {
-    this->_setupForklifts(logFile);
-    this->_boxLeft = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW, glm::translate(MODEL, glm::vec3{2.0f, 0.0f, 3.0f}));
-    this->_boxCenter = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW,glm::translate(MODEL, glm::vec3{0.0f, 0.0f, 3.0f}));
-    this->_boxRight = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW, glm::translate(MODEL, glm::vec3{-2.0f, 0.0f, 3.0f}));
+    float angle{glm::radians(pose.angle)};
+    glm::mat4 matrix{this->_heading(std::cos(angle), std::sin(angle))};
+    matrix[3] = this->_cellOrigin(pose.x, pose.y);
+    return matrix;
 }
 
-void Game::_setupForklifts(const std::string& logFile)
+void Game::seek(unsigned int tick)
 {
-    std::ifstream file(logFile);
-    if (!file.is_open()) 
+    while (!this->_parser->done() && (this->_episode.events.empty() || this->_episode.events.back().tick < tick))
     {
-        std::cerr << "Failed to open file.\n";
-        exit(1);
+        this->_receiveEvents();
+        this->_parser->waitForEvents(EVENT_WAIT_MS);
     }
-    std::regex pattern(R"(([RBG]) robot \d in position \[(\d),(\d)\])");
-    std::string line;
-    glm::vec3 color;
-    while (std::getline(file, line))
+    this->_receiveEvents();
+    this->_jumpTo(this->_timeline.eventIndexAt(tick));
+}
+
+void Game::_jumpTo(std::size_t eventIndex)
+{
+    this->_scheduler.clear();
+    this->_nextEvent = std::min(eventIndex, this->_episode.events.size());
+    this->_state = this->_timeline.stateAt(this->_nextEvent);
+    this->_undo.clear();
+    this->_undoBegin = this->_nextEvent;
+    this->_applyState(this->_state);
+}
+
+void Game::_receiveEvents()
+{
+    Event event;
+    while (this->_parser->pop(event))
+        this->_episode.events.push_back(event);
+    if (!this->_follow)
+        this->_timeline.update();
+}
+
+void Game::_applyState(const SimulationState& state)
+{
+    for (unsigned int i=0; i<this->_forklifts.size(); ++i)
     {
-        std::smatch match;
-        if (std::regex_search(line, match, pattern))
-        {
-            int x = std::stoi(match[2]);
-            int y = std::stoi(match[3]); 
-            if (match[1] == "R") color = glm::vec3{0.8f, 0.2f, 0.2f};
-            else if (match[1] == "G") color = glm::vec3{0.2f, 0.8f, 0.2f};
-            else if (match[1] == "B") color = glm::vec3{0.2f, 0.2f, 0.8f};
-            this->_forklifts.emplace_back("assets/forklift/forklift.obj", PROJECTION, VIEW, glm::translate(MODEL, glm::vec3(4-x, 0.0f, y-4)), x, y, color);
-        }
+        const RobotState& robot{state.robots()[i]};
+        this->_placeForklift(i, this->_transform.cellMatrix(robot.x, robot.y, robot.orient));
+        if (robot.mail == NO_MAIL)
+            this->_boxes.despawn(this->_carriedBox(i));
+        else
+            this->_boxes.spawn(this->_carriedBox(i), this->_forklifts.modelMatrix(i));
+    }
+    for (unsigned int slot=0; slot<numPickupCells(this->_episode.boardSize); ++slot)
+    {
+        if (state.boxSpawned(slot))
+            this->generateBox(slot);
+        else
+            this->_boxes.despawn(slot);
     }
-    file.close();
 }
 
 void Game::render(GLFWwindow* window)
 {
     glClearColor(0.05f, 0.05f, 0.05f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    this->_camera.bind();
     this->_board.draw(this->_withtexture);
-    for (const auto& forklift : this->_forklifts) 
-    {
-        forklift.draw(this->_notexture, this->_withtexture);
-    }
-    if (this->_boxCenter)
-        this->_boxCenter->draw(this->_withtexture);
-    if (this->_boxLeft)
-        this->_boxLeft->draw(this->_withtexture);
-    if (this->_boxRight)
-        this->_boxRight->draw(this->_withtexture);
+    this->_forklifts.draw(this->_notexture);
+    this->_boxes.draw(this->_withtexture);
     glfwSwapBuffers(window);
 }
 
-
-void Game::moveForward(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::resize(int width, int height)
 {
-    for (unsigned int i=0; i<10; ++i)
-    {
-        this->_forklifts[forkliftIndex].translate(glm::vec3(0.0f, 0.0f, 0.1f));
-        this->render(window);
-    }
+    // minimized windows have an empty framebuffer
+    if (width <= 0 || height <= 0)
+        return;
+    this->_resizeTarget = static_cast<std::uint64_t>(width) << 32 | static_cast<std::uint32_t>(height);
 }
 
-void Game::turnLeft(unsigned int forkliftIndex, GLFWwindow* window)
+
+void Game::generateBox(unsigned int slot)
 {
-    for (unsigned int i=0; i<9; ++i)
-    {
-        this->_forklifts[forkliftIndex].rotate(glm::radians(-10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        this->render(window);
-    };
+    auto [x, y] = pickupCell(this->_episode.boardSize, slot);
+    this->_boxes.spawn(slot, this->_transform.cellMatrix(x, y, Orientation::DOWN));
 }
 
-void Game::turnRight(unsigned int forkliftIndex, GLFWwindow* window)
+std::size_t Game::_carriedBox(unsigned int robot) const
 {
-    for (unsigned int i=0; i<9; ++i)
-    {
-        this->_forklifts[forkliftIndex].rotate(glm::radians(10.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        this->render(window);
-    };
+    return numPickupCells(this->_episode.boardSize) + robot;
 }
 
-void Game::turnBack(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_placeForklift(unsigned int robot, const glm::mat4& modelMatrix)
 {
-    for (unsigned int i=0; i<9; ++i)
-    {
-        this->_forklifts[forkliftIndex].rotate(glm::radians(20.0f), glm::vec3(0.0f, 1.0f, 0.0f));
-        this->render(window);
-    };
+    this->_forklifts.setModelMatrix(robot, modelMatrix);
+    this->_boxes.setModelMatrix(this->_carriedBox(robot), modelMatrix);
 }
 
-void Game::pickup(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_dispatch()
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    if (forklift->y() == 7)
+    while (this->_nextEvent < this->_episode.events.size())
     {
-        if (forklift->x() == 2)
-        {
-            switch (forklift->orientation()) 
-            {
-                case Orientation::UP:
-                    this->turnBack(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::DOWN:
-                    break;
-                case Orientation::LEFT:
-                    this->turnLeft(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::RIGHT:
-                    this->turnRight(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-            }
-            forklift->setBox(std::move(this->_boxLeft));
-        }
-        else if (forklift->x() == 4)
-        {
-            switch (forklift->orientation()) 
-            {
-                case Orientation::UP:
-                    this->turnBack(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::DOWN:
-                    break;
-                case Orientation::LEFT:
-                    this->turnLeft(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::RIGHT:
-                    this->turnRight(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-            }
-            forklift->setBox(std::move(this->_boxCenter));
-        } 
-        else if (forklift->x() == 6)
+        const Event& event{this->_episode.events[this->_nextEvent]};
+        if (!this->_scheduler.canStart(event, this->_state))
+            return;
+        if (event.type == EventType::WIN)
+            std::cout << "Player " << this->_episode.players[event.robot] << " wins at t=" << event.tick << std::endl;
+        // the simulation decides what happens, we only animate the difference
+        if (!this->_follow)
         {
-            switch (forklift->orientation()) 
+            // dropped in halves, so a long replay costs one erase per UNDO_HISTORY events
+            if (this->_undo.size() >= 2*UNDO_HISTORY)
             {
-                case Orientation::UP:
-                    this->turnBack(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::DOWN:
-                    break;
-                case Orientation::LEFT:
-                    this->turnLeft(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
-                case Orientation::RIGHT:
-                    this->turnRight(forkliftIndex, window);
-                    forklift->setOrientation(Orientation::DOWN);
-                    break;
+                this->_undo.erase(this->_undo.begin(), this->_undo.begin() + UNDO_HISTORY);
+                this->_undoBegin += UNDO_HISTORY;
             }
-            forklift->setBox(std::move(this->_boxRight));
+            this->_undo.push_back(this->_state.undoRecord(event));
         }
+        this->_scheduler.start(event, this->_state);
+        ++this->_nextEvent;
     }
 }
 
-void Game::generateBox(unsigned int forkliftIndex)
+void Game::_dispatchReversed()
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    if (forklift->y() == 7)
+    if (this->_nextEvent == 0 || !this->_scheduler.idle())
+        return;
+    std::size_t index{--this->_nextEvent};
+    const Event& event{this->_episode.events[index]};
+    UndoRecord record;
+    if (index >= this->_undoBegin)
     {
-        if (forklift->x() == 2)
-            this->_boxLeft = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW, glm::translate(MODEL, glm::vec3{2.0f, 0.0f, 3.0f}));
-        else if (forklift->x() == 4)
-            this->_boxCenter = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW,glm::translate(MODEL, glm::vec3{0.0f, 0.0f, 3.0f}));
-        else if (forklift->x() == 6)
-            this->_boxRight = std::make_unique<Box>("assets/box/box.obj", PROJECTION, VIEW, glm::translate(MODEL, glm::vec3{-2.0f, 0.0f, 3.0f}));
+        record = this->_undo.back();
+        this->_undo.pop_back();
     }
+    else
+    {
+        // played before the last jump or too long ago, the snapshot before it knows what it overwrote
+        record = this->_timeline.stateAt(index).undoRecord(event);
+        this->_undoBegin = index;
+    }
+    this->_scheduler.startReversed(event, record, this->_state);
 }
 
-void Game::dropoff(unsigned int forkliftIndex)
+void Game::_finishAll()
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    if (yellowCells.find({forklift->x(), forklift->y()}) != yellowCells.end())
-    {
-        forklift->setBox(nullptr);
-    }
+    while (std::optional<Action> action{this->_scheduler.finishNext(std::numeric_limits<double>::infinity())})
+        this->_finishAction(*action);
 }
 
-void Game::up(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_finishAction(const Action& action)
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    switch (forklift->orientation()) 
+    this->_placeForklift(action.robot, this->_transform.cellMatrix(action.end().x, action.end().y, action.end().orient));
+    std::size_t carried{this->_carriedBox(action.robot)};
+    if (action.reversed)
+    {
+        switch (action.type)
+        {
+            case EventType::MOVE:
+                if (action.from.emptiedSlot != NO_SLOT)
+                    this->_boxes.despawn(action.from.emptiedSlot);
+                break;
+            case EventType::PICKUP:
+                // the box goes back on the pickup cell it came from
+                this->_boxes.despawn(carried);
+                if (action.to.emptiedSlot != NO_SLOT)
+                    this->generateBox(action.to.emptiedSlot);
+                break;
+            case EventType::DROPOFF:
+                this->_boxes.spawn(carried, this->_forklifts.modelMatrix(action.robot));
+                break;
+            case EventType::WIN:
+                break;
+        }
+        return;
+    }
+    switch (action.type)
     {
-        case Orientation::UP:
-            this->moveForward(forkliftIndex, window);
+        case EventType::MOVE:
+            // the box taken on the last pickup is replaced once the robot drives away
+            if (action.from.emptiedSlot != NO_SLOT)
+                this->generateBox(action.from.emptiedSlot);
             break;
-        case Orientation::DOWN:
-            this->turnBack(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::UP);
+        case EventType::PICKUP:
+            if (action.to.emptiedSlot != NO_SLOT)
+                this->_boxes.despawn(action.to.emptiedSlot);
+            this->_boxes.spawn(carried, this->_forklifts.modelMatrix(action.robot));
             break;
-        case Orientation::LEFT:
-            this->turnRight(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::UP);
+        case EventType::DROPOFF:
+            this->_boxes.despawn(carried);
             break;
-        case Orientation::RIGHT:
-            this->turnLeft(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::UP);
+        case EventType::WIN:
             break;
     }
-    this->generateBox(forkliftIndex);
-    forklift->setY(forklift->y()-1);
-    this->pickup(forkliftIndex, window);
-    this->dropoff(forkliftIndex);
 }
 
-void Game::down(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_advance(double dt)
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    switch (forklift->orientation())
+    double time{this->_scheduler.clock() + dt};
+    bool reversed{this->_reversed};
+    auto dispatch{[this, reversed]() {
+        if (reversed)
+            this->_dispatchReversed();
+        else
+            this->_dispatch();
+    }};
+    dispatch();
+    // every finished action may free the event holding back the queue
+    while (std::optional<Action> action{this->_scheduler.finishNext(time)})
     {
-        case Orientation::UP:
-            this->turnBack(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::DOWN);
-            break;
-        case Orientation::DOWN:
-            this->moveForward(forkliftIndex, window);
-            break;
-        case Orientation::LEFT:
-            this->turnLeft(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::DOWN);
-            break;
-        case Orientation::RIGHT:
-            this->turnRight(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::DOWN);
-            break;
+        this->_finishAction(*action);
+        dispatch();
     }
-    this->generateBox(forkliftIndex);
-    forklift->setY(forklift->y()+1);
-    this->pickup(forkliftIndex, window);
-    this->dropoff(forkliftIndex);
+    this->_scheduler.advanceTo(time);
 }
 
-void Game::left(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_updateTransforms(double lag)
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    switch (forklift->orientation()) 
+    double time{this->_scheduler.clock() + lag};
+    for (const std::optional<Action>& action : this->_scheduler.actions())
     {
-        case Orientation::UP:
-            this->turnLeft(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::LEFT);
-            break;
-        case Orientation::DOWN:
-            this->turnRight(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::LEFT);
-            break;
-        case Orientation::LEFT:
-            this->moveForward(forkliftIndex, window);
-            break;
-        case Orientation::RIGHT:
-            this->turnBack(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::LEFT);
-            break;
+        if (action)
+            this->_placeForklift(action->robot, this->_transform.poseMatrix(action->poseAt(time - action->start)));
     }
-    this->generateBox(forkliftIndex);
-    forklift->setX(forklift->x()-1);
-    this->pickup(forkliftIndex, window);
-    this->dropoff(forkliftIndex);
 }
 
-void Game::right(unsigned int forkliftIndex, GLFWwindow* window)
+void Game::_advanceFor(double budget)
 {
-    Forklift* forklift{&this->_forklifts[forkliftIndex]};
-    switch (forklift->orientation())
+    double deadline{glfwGetTime() + budget};
+    do
     {
-        case Orientation::UP:
-            this->turnRight(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::RIGHT);
-            break;
-        case Orientation::DOWN:
-            this->turnLeft(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::RIGHT);
-            break;
-        case Orientation::LEFT:
-            this->turnBack(forkliftIndex, window);
-            this->moveForward(forkliftIndex, window);
-            forklift->setOrientation(Orientation::RIGHT);
-            break;
-        case Orientation::RIGHT:
-            this->moveForward(forkliftIndex, window);
-            break;
+        // a long step lets chains of actions finish inside one call
+        this->_advance(1.0);
     }
-    this->generateBox(forkliftIndex);
-    forklift->setX(forklift->x()+1);
-    this->pickup(forkliftIndex, window);
-    this->dropoff(forkliftIndex);
+    while ((!this->_scheduler.idle() || (this->_reversed ? this->_nextEvent > 0 : this->_nextEvent < this->_episode.events.size()))
+        && glfwGetTime() < deadline);
+}
+
+double Game::speed() const
+{
+    return this->_speed;
+}
+
+void Game::setSpeed(double speed)
+{
+    this->_speed = std::clamp(speed, MIN_SPEED, MAX_SPEED);
+}
+
+bool Game::maxSpeed() const
+{
+    return this->_maxSpeed;
+}
+
+void Game::setMaxSpeed(bool maxSpeed)
+{
+    this->_maxSpeed = maxSpeed;
 }
 
-void Game::run(const std::string& logFile, GLFWwindow* window)
+bool Game::reversed() const
 {
-    std::vector<std::pair<unsigned int, Orientation>> commands{prossessLogFile(logFile)};
-    for (const auto& command: commands)
+    return this->_reversed;
+}
+
+void Game::setReversed(bool reversed)
+{
+    this->_reversed = reversed && !this->_follow;
+}
+
+double Game::position() const
+{
+    return this->_position;
+}
+
+void Game::scrubTo(double position)
+{
+    if (!this->_follow)
+        this->_scrubTarget = std::clamp(position, 0.0, 1.0);
+}
+
+void Game::run(GLFWwindow* window)
+{
+    double previous{glfwGetTime()};
+    double lag{0.0};
+    bool vsync{true};
+    bool reversed{false};
+    // the framebuffer may have changed since the window opened, or be larger than asked for on retina displays
+    int width, height;
+    glfwGetFramebufferSize(window, &width, &height);
+    this->resize(width, height);
+    while (!glfwWindowShouldClose(window))
     {
-        if (glfwWindowShouldClose(window))
-            return;
-        switch (command.second) 
-        {        
-            case Orientation::UP:
-                this->up(command.first, window);
-                break;
-            case Orientation::DOWN:
-                this->down(command.first, window);
-                break;
-            case Orientation::LEFT:
-                this->left(command.first, window);
-                break;
-            case Orientation::RIGHT:
-                this->right(command.first, window);
-                break;
+        // in max speed mode time spent waiting for the display is time not spent simulating
+        if (vsync == this->_maxSpeed)
+        {
+            vsync = !vsync;
+            glfwSwapInterval(vsync ? 1 : 0);
+        }
+        double now{glfwGetTime()};
+        double frameTime{std::min(now - previous, MAX_FRAME_TIME)};
+        previous = now;
+        this->_receiveEvents();
+        // resize callbacks run on the input thread, GL and the camera belong to this one
+        std::uint64_t resizeTarget{this->_resizeTarget.exchange(0)};
+        if (resizeTarget != 0)
+        {
+            width = static_cast<int>(resizeTarget >> 32);
+            height = static_cast<int>(resizeTarget & 0xffffffffu);
+            glViewport(0, 0, width, height);
+            this->_camera.setProjectionMatrix(projectionMatrix((float)width / (float)height));
+        }
+        double scrubTarget{this->_scrubTarget.exchange(-1.0)};
+        if (scrubTarget >= 0.0)
+            this->_jumpTo(static_cast<std::size_t>(scrubTarget*this->_episode.events.size()));
+        // actions in flight when the direction changes end where they were heading
+        if (reversed != this->_reversed)
+        {
+            reversed = !reversed;
+            this->_finishAll();
         }
+        if (this->_maxSpeed)
+        {
+            this->_advanceFor(MAX_SPEED_FRAME_BUDGET);
+            lag = 0.0;
+        }
+        else
+        {
+            // faster playback takes more steps per frame, in-between poses are never drawn
+            lag += frameTime*this->_speed;
+            while (lag >= SIMULATION_TIMESTEP)
+            {
+                this->_advance(SIMULATION_TIMESTEP);
+                lag -= SIMULATION_TIMESTEP;
+            }
+        }
+        if (this->_scheduler.idle() && this->_nextEvent >= this->_episode.events.size())
+        {
+            // a replay stays open at its end so it can still be rewound
+            if (this->_follow && this->_parser->done())
+                return;
+            // drop played events so hours of following don't pile up in memory
+            if (this->_follow && this->_nextEvent >= FOLLOW_HISTORY)
+            {
+                this->_episode.events.erase(this->_episode.events.begin(), this->_episode.events.begin() + this->_nextEvent);
+                this->_nextEvent = 0;
+            }
+        }
+        this->_position = this->_episode.events.empty() ? 0.0 : static_cast<double>(this->_nextEvent) / this->_episode.events.size();
+        this->_updateTransforms(lag);
+        this->render(window);
     }
 }
-
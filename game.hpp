@@ -3,71 +3,186 @@
 #include <iostream>
 #include <memory>
 #include <string>
-#include <unordered_set>
-#include <unordered_map>
+#include <array>
+#include <vector>
+#include <atomic>
+#include <cstdint>
 #include <glm/glm.hpp>
 
 
 #include "shader.hpp"
 #include "model.hpp"
+#include "camera.hpp"
+#include "episode.hpp"
+#include "simulation.hpp"
+#include "timeline.hpp"
+#include "parser.hpp"
+#include "animation.hpp"
+#include "scheduler.hpp"
 
 inline constexpr unsigned int SCR_WIDTH{800};
 inline constexpr unsigned int SCR_HEIGHT{600};
-inline const glm::mat4 PROJECTION{glm::perspective(glm::radians(45.0f), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 100.0f)};
+// perspective of a framebuffer width/height times as wide as it is high
+inline glm::mat4 projectionMatrix(float aspect)
+{
+    return glm::perspective(glm::radians(45.0f), aspect, 0.1f, 100.0f);
+}
+inline const glm::mat4 PROJECTION{projectionMatrix((float)SCR_WIDTH / (float)SCR_HEIGHT)};
 inline const glm::mat4 VIEW{glm::lookAt(glm::vec3{0.0f, -3.0f, 4.0f}, glm::vec3{0.0f, 0.0f, 0.0f}, glm::vec3{0.0f,-1.0f, 0.0f})};
 inline const glm::mat4 MODEL{glm::scale(glm::mat4(1.0f), glm::vec3(0.45f, 0.45f, 0.45f))};
 
-struct PairHash {
-    template <typename T1, typename T2>
-    std::size_t operator()(const std::pair<T1, T2>& p) const {
-        auto h1 = std::hash<T1>{}(p.first);
-        auto h2 = std::hash<T2>{}(p.second);
-        return h1 ^ (h2 << 1);
-    }
-};
+inline constexpr char BOARD_MODEL[]{"assets/board/board.obj"};
+inline constexpr char FORKLIFT_MODEL[]{"assets/forklift/forklift.obj"};
+inline constexpr char BOX_MODEL[]{"assets/box/box.obj"};
 
-inline const std::unordered_set<std::pair<int, int>, PairHash> yellowCells
+// colors of the PLAYERS, red, blue and green
+inline const glm::vec3 PLAYER_COLORS[]
 {
-    {2, 0}, {4, 0}, {6, 0}, 
-    {0, 2}, {0, 4}, {0, 6},
-    {8, 2}, {8, 4}, {8, 6}
+    {0.8f, 0.2f, 0.2f},
+    {0.2f, 0.2f, 0.8f},
+    {0.2f, 0.8f, 0.2f}
 };
+// shader storage binding of the palette notexture.fs colors forklifts from
+inline constexpr unsigned int PALETTE_BINDING{0};
+
+// forklift color of every player, PLAYER_COLORS first and then hues spread around the color wheel
+std::vector<glm::vec3> playerPalette(unsigned int numPlayers);
+
+// played events kept in memory while following a live log
+inline constexpr std::size_t FOLLOW_HISTORY{4096};
+// undo records kept for playing backwards, older events are undone from timeline snapshots
+inline constexpr std::size_t UNDO_HISTORY{4096};
+
+// playback speed range, as multiples of the normal animation speed
+inline constexpr double MIN_SPEED{0.25};
+inline constexpr double MAX_SPEED{64.0};
+// wall time a frame may spend simulating in max speed mode before it draws
+inline constexpr double MAX_SPEED_FRAME_BUDGET{1.0 / 30.0};
 
-inline const std::unordered_map<std::string, unsigned int> COLOR2INT
+// places things on a board of any size. larger boards are scaled down to fill the same view,
+// the board model itself is the 9x9 one stretched over them
+class BoardTransform
 {
-    {"R", 0},
-    {"B", 1},
-    {"G", 2}
-};
+public:
+    explicit BoardTransform(unsigned int boardSize = BOARD_SIZE);
+    // model matrix of the board itself
+    const glm::mat4& boardMatrix() const;
+    // model matrix of anything standing on cell (x, y) and facing orient, the same bits however it got there
+    glm::mat4 cellMatrix(unsigned int x, unsigned int y, Orientation orient) const;
+    // model matrix of a robot on its way between cells or orientations
+    glm::mat4 poseMatrix(const Pose& pose) const;
+private:
+    glm::mat4 _board;
+    // MODEL scaled so that one cell is one unit
+    glm::mat4 _scene;
+    // cell coordinate of the board center
+    float _center;
+    // _scene facing each orientation, indexed by Orientation. quarter turns are exact, unlike cos(radians(90))
+    std::array<glm::mat4, 4> _orientations;
 
-std::vector<std::pair<unsigned int, Orientation>> prossessLogFile(const std::string& logFile);
+    // _scene turned about the y axis, from the cosine and sine of the heading
+    glm::mat4 _heading(float cosine, float sine) const;
+    glm::vec4 _cellOrigin(float x, float y) const;
+};
 
 class Game
 {
 public:
-    Game(const std::string& logFile);
+    // with follow, keep reading events the environment appends to logFile. the window stays closable
+    // while a followed log has no header yet, closing it then leaves a game that run() returns from at once.
+    // boardSize as for ParserThread
+    Game(GLFWwindow* window, const std::string& logFile, bool follow = false, unsigned int boardSize = 0);
+    // deletes the palette buffer, the GL context must still be current
+    ~Game();
+    Game(const Game&) = delete;
+    Game& operator=(const Game&) = delete;
     void render(GLFWwindow* window);
-    void moveForward(unsigned int forkliftIndex, GLFWwindow* window);
-    void turnLeft(unsigned int forkliftIndex, GLFWwindow* window);
-    void turnRight(unsigned int forkliftIndex, GLFWwindow* window);
-    void turnBack(unsigned int forkliftIndex, GLFWwindow* window);
-    void pickup(unsigned int forkliftIndex, GLFWwindow* window);
-    void dropoff(unsigned int forkliftIndex);
-    void generateBox(unsigned int forkliftIndex);
-    void up(unsigned int forkliftIndex, GLFWwindow* window);
-    void down(unsigned int forkliftIndex, GLFWwindow* window);
-    void left(unsigned int forkliftIndex, GLFWwindow* window);
-    void right(unsigned int forkliftIndex, GLFWwindow* window);
-    void run(const std::string& logFile, GLFWwindow* window);
+    // fit the viewport and projection to a framebuffer of width x height on the next frame.
+    // safe to call from the input thread while run() plays
+    void resize(int width, int height);
+    // show the box of pickup cell slot
+    void generateBox(unsigned int slot);
+    // jump to the state right before the first event at or after tick, waits for the parser to reach it.
+    // not available when following
+    void seek(unsigned int tick);
+    // draw frames as fast as the display allows, events play at MOVE_DURATION and TURN_DURATION whatever the frame rate.
+    // robots animate side by side, see ActionScheduler
+    void run(GLFWwindow* window);
+    // safe to call from the input thread while run() plays, like everything below
+    double speed() const;
+    // clamped to [MIN_SPEED, MAX_SPEED]
+    void setSpeed(double speed);
+    bool maxSpeed() const;
+    // play events as fast as the simulation goes, drawing one frame every MAX_SPEED_FRAME_BUDGET
+    void setMaxSpeed(bool maxSpeed);
+    bool reversed() const;
+    // play events backwards, undoing them one at a time. not available when following
+    void setReversed(bool reversed);
+    // fraction of the received events played so far
+    double position() const;
+    // jump to a fraction of the received events on the next frame, from the nearest snapshot.
+    // not available when following
+    void scrubTo(double position);
 private:
+    Episode _episode;
+    Timeline _timeline;
+    // index of the next event run() plays
+    std::size_t _nextEvent{0};
+    // logical state after the events played so far
+    SimulationState _state;
+    bool _follow{false};
+    std::atomic<double> _speed{1.0};
+    std::atomic<bool> _maxSpeed{false};
+    std::atomic<bool> _reversed{false};
+    std::atomic<double> _position{0.0};
+    // position to jump to, negative when there is none
+    std::atomic<double> _scrubTarget{-1.0};
+    // framebuffer size to fit, width in the high 32 bits and height in the low ones. 0 when there is none
+    std::atomic<std::uint64_t> _resizeTarget{0};
+    std::unique_ptr<ParserThread> _parser{nullptr};
+    // projection and view of every model, bound once per frame
+    Camera _camera;
     Board _board;
     Shader _notexture;
     Shader _withtexture;
-    std::vector<Forklift> _forklifts;
-    std::unique_ptr<Box> _boxLeft{nullptr};
-    std::unique_ptr<Box> _boxCenter{nullptr};
-    std::unique_ptr<Box> _boxRight{nullptr};
-    void _setupForklifts(const std::string& logFile);
+    // shader storage buffer holding playerPalette() as vec4s
+    unsigned int _palette{0};
+    BoardTransform _transform;
+    ForkliftFleet _forklifts;
+    // slot i < numPickupCells() is the box waiting on pickup cell i, the box robot r carries is
+    // slot numPickupCells() + r
+    BoxPool _boxes;
+    // events being animated, already applied to _state
+    ActionScheduler _scheduler;
+    // records for the events in [_undoBegin, _nextEvent), at most twice UNDO_HISTORY of them.
+    // older ones are rebuilt from the timeline
+    std::vector<UndoRecord> _undo;
+    std::size_t _undoBegin{0};
+    void _setupForklifts();
+    void _setupPalette();
+    std::size_t _carriedBox(unsigned int robot) const;
+    // move a forklift and the box it may carry
+    void _placeForklift(unsigned int robot, const glm::mat4& modelMatrix);
+    // place forklifts and boxes as in state, without animating
+    void _applyState(const SimulationState& state);
+    // append events decoded by the parser thread so far
+    void _receiveEvents();
+    // move the animation clock forward by dt seconds, starting and finishing actions on the way
+    void _advance(double dt);
+    // advance until budget seconds of wall time are used up or nothing is left to play
+    void _advanceFor(double budget);
+    // start every next event that doesn't wait on an in-flight action
+    void _dispatch();
+    // start undoing the last played event once nothing is in flight
+    void _dispatchReversed();
+    // end every in-flight action right away
+    void _finishAll();
+    // show the state before event eventIndex, without animating
+    void _jumpTo(std::size_t eventIndex);
+    // snap the robot to where the action ends and hand over boxes
+    void _finishAction(const Action& action);
+    // pose the animated forklifts lag seconds past the last simulation step
+    void _updateTransforms(double lag);
 };
 
 #endif
\ No newline at end of file
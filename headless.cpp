@@ -0,0 +1,50 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+
+#include "headless.hpp"
+#include "episode.hpp"
+#include "simulation.hpp"
+
+// rejected events printed before we only count them
+inline constexpr unsigned int MAX_REPORTED_ERRORS{10};
+
+int runHeadless(const std::string& logFile, unsigned int boardSize)
+{
+    auto start{std::chrono::steady_clock::now()};
+    Episode episode{loadEpisode(logFile, boardSize)};
+    auto loaded{std::chrono::steady_clock::now()};
+    SimulationState state{episode};
+    unsigned int numErrors{0};
+    for (const Event& event : episode.events)
+    {
+        if (const char* error{state.check(event)})
+        {
+            if (numErrors < MAX_REPORTED_ERRORS)
+                std::cerr << "t=" << event.tick << " robot " << event.robot << ": " << error << "\n";
+            ++numErrors;
+            // an unknown robot can't be applied, anything else is applied as logged
+            if (event.robot >= state.robots().size() && event.type != EventType::WIN)
+                continue;
+        }
+        state.apply(event);
+    }
+    auto simulated{std::chrono::steady_clock::now()};
+
+    std::chrono::duration<double> loadTime{loaded - start};
+    std::chrono::duration<double> simulationTime{simulated - loaded};
+    std::cout << episode.events.size() << " events, " << state.robots().size() << " robots on a "
+              << episode.boardSize << "x" << episode.boardSize << " board\n";
+    std::cout << "load:      " << loadTime.count()*1000.0 << " ms\n";
+    std::cout << "simulate:  " << simulationTime.count()*1000.0 << " ms ("
+              << episode.events.size() / simulationTime.count() / 1e6 << " M events/s)\n";
+    // a log may name a winner beyond the players it has letters for
+    if (state.winner() >= 0 && static_cast<std::size_t>(state.winner()) < episode.players.size())
+        std::cout << "winner:    " << episode.players[state.winner()] << "\n";
+    else if (state.winner() >= 0)
+        std::cout << "winner:    player " << state.winner() << "\n";
+    else
+        std::cout << "winner:    none\n";
+    std::cout << "rejected:  " << numErrors << " events\n";
+    return numErrors > 0 ? 1 : 0;
+}
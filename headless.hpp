@@ -0,0 +1,9 @@
+#ifndef HEADLESS_H
+#define HEADLESS_H
+#include <string>
+
+// replay a log or .rbr replay without a window, report throughput and events that don't fit the state.
+// returns the process exit code, 1 if any event was rejected. boardSize as for loadEpisode
+int runHeadless(const std::string& logFile, unsigned int boardSize = 0);
+
+#endif
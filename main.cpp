@@ -1,5 +1,11 @@
 #include <iostream>
+#include <string>
 #include <thread>
+
+#include "episode.hpp"
+#include "headless.hpp"
+// -DHEADLESS_ONLY builds --headless alone, without OpenGL, GLFW or Assimp
+#ifndef HEADLESS_ONLY
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
@@ -10,10 +16,66 @@
 #include "game.hpp"
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height);
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods);
+void cursor_position_callback(GLFWwindow* window, double x, double y);
 void escapeListener(GLFWwindow* window);
+#endif
 
 int main(int argc, char** argv)
 {
+    if (argc < 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <log file> [--board-size <n>] [--start <tick>] [--speed <x>|max] [--follow] [--headless]\n";
+        return 1;
+    }
+    // 0 infers it from the log
+    unsigned int boardSize{0};
+#ifndef HEADLESS_ONLY
+    unsigned int startTick{0};
+    double speed{1.0};
+    bool maxSpeed{false};
+    bool follow{false};
+    bool headless{false};
+#endif
+    for (int i=2; i<argc; ++i)
+    {
+        std::string arg{argv[i]};
+        if (arg == "--board-size" && i+1 < argc)
+        {
+            unsigned long size{std::stoul(argv[++i])};
+            if (size == 0 || size > MAX_BOARD_SIZE)
+            {
+                std::cerr << "Board size must be 1 to " << MAX_BOARD_SIZE << ".\n";
+                return 1;
+            }
+            boardSize = static_cast<unsigned int>(size);
+        }
+#ifndef HEADLESS_ONLY
+        else if (arg == "--start" && i+1 < argc)
+            startTick = static_cast<unsigned int>(std::stoul(argv[++i]));
+        else if (arg == "--speed" && i+1 < argc)
+        {
+            std::string value{argv[++i]};
+            if (value == "max")
+                maxSpeed = true;
+            else
+                speed = std::stod(value);
+        }
+        else if (arg == "--follow")
+            follow = true;
+        else if (arg == "--headless")
+            headless = true;
+#endif
+    }
+#ifdef HEADLESS_ONLY
+    // built without a window, every run checks the log
+    return runHeadless(argv[1], boardSize);
+#else
+    // no window or OpenGL context needed to check a log
+    if (headless)
+        return runHeadless(argv[1], boardSize);
+
     // glfw: initialize and configure
     glfwInit();
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
@@ -33,9 +95,9 @@ int main(int argc, char** argv)
         return 1;
     }
     glfwMakeContextCurrent(window);
+    // one frame per display refresh, the animation clock makes up for whatever rate that is
+    glfwSwapInterval(1);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    // tell GLFW to capture our mouse
-    glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
     // glad: load all OpenGL function pointers
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress))
     {
@@ -47,26 +109,107 @@ int main(int argc, char** argv)
     // configure global opengl state
     glEnable(GL_DEPTH_TEST);
 
-    Game* game{new Game{argv[1]}}; 
+    Game* game{new Game{window, argv[1], follow, boardSize}}; 
+    // a followed log always starts at its live end
+    if (startTick > 0 && !follow && !glfwWindowShouldClose(window))
+        game->seek(startTick);
+    game->setSpeed(speed);
+    game->setMaxSpeed(maxSpeed);
+    glfwSetWindowUserPointer(window, game);
+    glfwSetKeyCallback(window, key_callback);
+    glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetCursorPosCallback(window, cursor_position_callback);
     std::thread escThread(escapeListener, window);
-    game->run(argv[1], window);
-    delete game;
+    game->run(window);
+    // the listener polls events until it sees the window closing, callbacks it runs meanwhile find no game
+    glfwSetWindowUserPointer(window, nullptr);
     // Wait for thread to finish
     escThread.join();
+    delete game;
     // glfw: terminate, clearing all previously allocated GLFW resources.
     glfwDestroyWindow(window);
     glfwTerminate();
     return 0;
+#endif
 };
 
-// glfw: whenever the window size changed (by OS or user resize) this callback function executes
+#ifndef HEADLESS_ONLY
+
+// glfw: whenever the window size changed (by OS or user resize) this callback function executes.
+// it runs on the thread polling events, the game fits the viewport and projection on its next frame
 void framebuffer_size_callback(GLFWwindow* window, int width, int height)
 {
-    // make sure the viewport matches the new window dimensions; note that width and 
-    // height will be significantly larger than specified on retina displays.
-    glViewport(0, 0, width, height);
+    // none yet while the game loads, run() picks up the size it starts with
+    Game* game{static_cast<Game*>(glfwGetWindowUserPointer(window))};
+    if (game != nullptr)
+        game->resize(width, height);
 };
 
+// +/- double or halve the playback speed, m toggles max speed, r plays backwards.
+// left/right step through the replay by 1%, home/end jump to its ends
+void key_callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+    Game* game{static_cast<Game*>(glfwGetWindowUserPointer(window))};
+    if (action == GLFW_RELEASE || game == nullptr)
+        return;
+    switch (key)
+    {
+        case GLFW_KEY_EQUAL:
+        case GLFW_KEY_KP_ADD:
+            game->setSpeed(game->speed()*2.0);
+            break;
+        case GLFW_KEY_MINUS:
+        case GLFW_KEY_KP_SUBTRACT:
+            game->setSpeed(game->speed()/2.0);
+            break;
+        case GLFW_KEY_M:
+            if (action == GLFW_PRESS)
+                game->setMaxSpeed(!game->maxSpeed());
+            break;
+        case GLFW_KEY_R:
+            if (action == GLFW_PRESS)
+                game->setReversed(!game->reversed());
+            break;
+        case GLFW_KEY_LEFT:
+            game->scrubTo(game->position() - 0.01);
+            break;
+        case GLFW_KEY_RIGHT:
+            game->scrubTo(game->position() + 0.01);
+            break;
+        case GLFW_KEY_HOME:
+            game->scrubTo(0.0);
+            break;
+        case GLFW_KEY_END:
+            game->scrubTo(1.0);
+            break;
+    }
+}
+
+// clicking or dragging with the left button scrubs, the window width spans the whole replay
+void scrubToCursor(GLFWwindow* window, double x)
+{
+    Game* game{static_cast<Game*>(glfwGetWindowUserPointer(window))};
+    int width, height;
+    glfwGetWindowSize(window, &width, &height);
+    if (game != nullptr && width > 0)
+        game->scrubTo(x / width);
+}
+
+void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
+{
+    if (button != GLFW_MOUSE_BUTTON_LEFT || action != GLFW_PRESS)
+        return;
+    double x, y;
+    glfwGetCursorPos(window, &x, &y);
+    scrubToCursor(window, x);
+}
+
+void cursor_position_callback(GLFWwindow* window, double x, double y)
+{
+    if (glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS)
+        scrubToCursor(window, x);
+}
+
 void escapeListener(GLFWwindow* window) {
     while (!glfwWindowShouldClose(window)) {
         if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS) {
@@ -75,4 +218,5 @@ void escapeListener(GLFWwindow* window) {
         }
         glfwPollEvents();
     }
-}
\ No newline at end of file
+}
+#endif
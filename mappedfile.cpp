@@ -0,0 +1,75 @@
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "mappedfile.hpp"
+
+MappedFile::MappedFile(const std::string& path)
+{
+    int fd{open(path.c_str(), O_RDONLY)};
+    if (fd < 0)
+        return;
+    struct stat info;
+    if (fstat(fd, &info) == 0)
+    {
+        this->_size = static_cast<std::size_t>(info.st_size);
+        // an empty file can't be mapped but is still a valid, empty log
+        if (this->_size == 0)
+            this->_open = true;
+        else
+        {
+            void* data{mmap(nullptr, this->_size, PROT_READ, MAP_PRIVATE, fd, 0)};
+            if (data != MAP_FAILED)
+            {
+                // pages are read once front to back, let the kernel read ahead and drop them behind us
+                madvise(data, this->_size, MADV_SEQUENTIAL);
+                this->_data = static_cast<const char*>(data);
+                this->_open = true;
+            }
+        }
+    }
+    // the mapping stays valid after the descriptor is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if (this->_data)
+        munmap(const_cast<char*>(this->_data), this->_size);
+}
+
+bool MappedFile::isOpen() const
+{
+    return this->_open;
+}
+
+std::string_view MappedFile::data() const
+{
+    return std::string_view(this->_data, this->_data ? this->_size : 0);
+}
+
+const char* findNewline(const char* begin, const char* end)
+{
+#ifdef __AVX2__
+    // compare 32 bytes at a time, lines are short so most lookups end in the first block
+    const __m256i newlines{_mm256_set1_epi8('\n')};
+    while (end - begin >= 32)
+    {
+        __m256i block{_mm256_loadu_si256(reinterpret_cast<const __m256i*>(begin))};
+        unsigned int mask = static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, newlines)));
+        if (mask)
+            return begin + __builtin_ctz(mask);
+        begin += 32;
+    }
+#endif
+    // glibc's memchr is vectorized as well, used for the tail and on non-AVX2 builds
+    const void* newline{std::memchr(begin, '\n', end - begin)};
+    return newline ? static_cast<const char*>(newline) : end;
+}
@@ -0,0 +1,56 @@
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+// read-only memory mapping of a whole file
+class MappedFile
+{
+public:
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    bool isOpen() const;
+    std::string_view data() const;
+private:
+    const char* _data{nullptr};
+    std::size_t _size{0};
+    bool _open{false};
+};
+
+// first '\n' in [begin, end), or end if there is none
+const char* findNewline(const char* begin, const char* end);
+
+// call f with every line of text, newline excluded, without copying
+template <typename F>
+void forEachLine(std::string_view text, F f)
+{
+    const char* begin{text.data()};
+    const char* end{text.data() + text.size()};
+    while (begin < end)
+    {
+        const char* newline{findNewline(begin, end)};
+        f(std::string_view(begin, newline - begin));
+        begin = newline + 1;
+    }
+}
+
+// call f with every line of text until it returns false, false if it stopped early
+template <typename F>
+bool forEachLineWhile(std::string_view text, F f)
+{
+    const char* begin{text.data()};
+    const char* end{text.data() + text.size()};
+    while (begin < end)
+    {
+        const char* newline{findNewline(begin, end)};
+        if (!f(std::string_view(begin, newline - begin)))
+            return false;
+        begin = newline + 1;
+    }
+    return true;
+}
+
+#endif
@@ -0,0 +1,55 @@
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "modeldata.hpp"
+#include "meshopt.hpp"
+
+// vertex cache efficiency of a model before and after optimizeMesh
+void benchModel(const std::string& path)
+{
+    std::optional<ModelData> model{importModel(path)};
+    if (!model)
+        exit(1);
+    std::size_t numVertices[2]{0, 0};
+    std::size_t numTriangles{0};
+    std::size_t indexBytes[2]{0, 0};
+    double misses[2]{0.0, 0.0};
+    std::chrono::duration<double> elapsed{0.0};
+    std::cout << std::fixed << std::setprecision(3);
+    for (MeshData& mesh : model->meshes)
+    {
+        std::vector<unsigned int> before{unpackIndices(mesh.indices.data(), mesh.numIndices(), mesh.numVertices())};
+        std::size_t verticesBefore{mesh.numVertices()};
+        numVertices[0] += verticesBefore;
+        indexBytes[0] += mesh.indices.size();
+        auto start{std::chrono::steady_clock::now()};
+        optimizeMesh(mesh);
+        elapsed += std::chrono::steady_clock::now() - start;
+        std::vector<unsigned int> after{unpackIndices(mesh.indices.data(), mesh.numIndices(), mesh.numVertices())};
+        numVertices[1] += mesh.numVertices();
+        indexBytes[1] += mesh.indices.size();
+        double acmr[2]{averageCacheMissRatio(before, VERTEX_CACHE_SIZE), averageCacheMissRatio(after, VERTEX_CACHE_SIZE)};
+        numTriangles += after.size()/3;
+        misses[0] += acmr[0]*(before.size()/3);
+        misses[1] += acmr[1]*(after.size()/3);
+        std::cout << model->materials[mesh.material].name << ": " << after.size()/3 << " triangles, "
+            << verticesBefore << " -> " << mesh.numVertices() << " vertices, ACMR " << acmr[0] << " -> " << acmr[1] << "\n";
+    }
+    if (numTriangles == 0)
+        return;
+    std::cout << "total:     " << numTriangles << " triangles, " << numVertices[0] << " -> " << numVertices[1] << " vertices\n";
+    std::cout << "ACMR:      " << misses[0] / numTriangles << " -> " << misses[1] / numTriangles
+        << " (FIFO cache of " << VERTEX_CACHE_SIZE << ")\n";
+    std::cout << "indices:   " << indexBytes[0] << " -> " << indexBytes[1] << " bytes\n";
+    std::cout << "optimize:  " << elapsed.count()*1000.0 << " ms\n";
+}
+
+int main(int argc, char** argv)
+{
+    benchModel(argc > 1 ? argv[1] : "assets/forklift/forklift.obj");
+    return 0;
+}
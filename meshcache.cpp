@@ -0,0 +1,246 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "meshcache.hpp"
+
+namespace
+{
+
+// 64 bit FNV-1a, folded over every source file in turn
+constexpr std::uint64_t FNV_OFFSET{14695981039346656037ull};
+constexpr std::uint64_t FNV_PRIME{1099511628211ull};
+
+std::uint64_t hashBytes(std::uint64_t hash, std::string_view bytes)
+{
+    for (char byte : bytes)
+    {
+        hash ^= static_cast<unsigned char>(byte);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+std::uint64_t hashFile(std::uint64_t hash, const std::string& path)
+{
+    MappedFile file(path);
+    // a missing file hashes differently from an empty one
+    if (!file.isOpen())
+        return hashBytes(hash, "\xff");
+    return hashBytes(hash, file.data());
+}
+
+BakedString addString(std::string& strings, const std::string& text)
+{
+    BakedString baked{static_cast<std::uint32_t>(strings.size()), static_cast<std::uint32_t>(text.size())};
+    strings += text;
+    return baked;
+}
+
+// copy a T out of data at offset, false if it doesn't fit
+template <typename T>
+bool read(std::string_view data, std::size_t offset, T& value)
+{
+    if (offset > data.size() || data.size() - offset < sizeof(T))
+        return false;
+    std::memcpy(&value, data.data() + offset, sizeof(T));
+    return true;
+}
+
+bool readString(std::string_view strings, const BakedString& baked, std::string& text)
+{
+    if (baked.offset > strings.size() || strings.size() - baked.offset < baked.size)
+        return false;
+    text.assign(strings.substr(baked.offset, baked.size));
+    return true;
+}
+
+}
+
+std::uint64_t hashModelSources(const std::string& path)
+{
+    std::uint64_t hash{hashFile(FNV_OFFSET, path)};
+    std::filesystem::path directory{std::filesystem::path(path).parent_path()};
+    if (directory.empty())
+        directory = ".";
+    std::vector<std::string> materialFiles;
+    std::error_code error;
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(directory, error))
+        if (entry.path().extension() == ".mtl")
+            materialFiles.push_back(entry.path().string());
+    // directory order is up to the file system
+    std::sort(materialFiles.begin(), materialFiles.end());
+    for (const std::string& materialFile : materialFiles)
+        hash = hashFile(hashBytes(hash, materialFile), materialFile);
+    return hash;
+}
+
+std::string bakedModelPath(const std::string& path)
+{
+    return path + ".rbm";
+}
+
+bool saveBakedModel(const ModelData& model, std::uint64_t sourceHash, const std::string& bakedFile)
+{
+    std::string strings;
+    std::vector<BakedString> textures;
+    std::vector<BakedMaterial> materials;
+    materials.reserve(model.materials.size());
+    for (const MaterialData& material : model.materials)
+    {
+        BakedMaterial baked{addString(strings, material.name), material.Ns,
+            {material.Ka.x, material.Ka.y, material.Ka.z},
+            {material.Kd.x, material.Kd.y, material.Kd.z},
+            {material.Ks.x, material.Ks.y, material.Ks.z},
+            static_cast<std::uint32_t>(textures.size()), static_cast<std::uint32_t>(material.diffuseTextures.size())};
+        for (const std::string& texture : material.diffuseTextures)
+            textures.push_back(addString(strings, texture));
+        materials.push_back(baked);
+    }
+    strings.resize((strings.size() + 3)/4*4, '\0');
+    std::vector<BakedMesh> meshes;
+    meshes.reserve(model.meshes.size());
+    for (const MeshData& mesh : model.meshes)
+        meshes.push_back(BakedMesh{mesh.material, static_cast<std::uint32_t>(mesh.numVertices()),
+            static_cast<std::uint32_t>(mesh.numIndices()), static_cast<std::uint32_t>(mesh.format)});
+    BakedHeader header;
+    std::memcpy(header.magic, BAKED_MAGIC, sizeof(BAKED_MAGIC));
+    header.version = BAKED_VERSION;
+    header.sourceHash = sourceHash;
+    header.numMaterials = static_cast<std::uint32_t>(materials.size());
+    header.numTextures = static_cast<std::uint32_t>(textures.size());
+    header.numMeshes = static_cast<std::uint32_t>(meshes.size());
+    header.stringsSize = static_cast<std::uint32_t>(strings.size());
+    header.reserved[0] = 0;
+    header.reserved[1] = 0;
+
+    std::string partFile{bakedFile + ".part"};
+    {
+        std::ofstream file(partFile, std::ios::binary);
+        if (!file.is_open())
+            return false;
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(materials.data()), materials.size()*sizeof(BakedMaterial));
+        file.write(reinterpret_cast<const char*>(textures.data()), textures.size()*sizeof(BakedString));
+        file.write(reinterpret_cast<const char*>(meshes.data()), meshes.size()*sizeof(BakedMesh));
+        file.write(strings.data(), strings.size());
+        for (const MeshData& mesh : model.meshes)
+        {
+            file.write(mesh.vertices.data(), mesh.vertices.size());
+            file.write(mesh.indices.data(), mesh.indices.size());
+        }
+        if (!file.good())
+        {
+            file.close();
+            std::filesystem::remove(partFile);
+            return false;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(partFile, bakedFile, error);
+    if (error)
+    {
+        std::filesystem::remove(partFile, error);
+        return false;
+    }
+    return true;
+}
+
+BakedModel::BakedModel(const std::string& bakedFile, std::uint64_t sourceHash)
+: _file{bakedFile}
+{
+    if (!this->_file.isOpen())
+        return;
+    std::string_view data{this->_file.data()};
+    BakedHeader header;
+    if (!read(data, 0, header)
+        || std::memcmp(header.magic, BAKED_MAGIC, sizeof(BAKED_MAGIC)) != 0
+        || header.version != BAKED_VERSION
+        || header.sourceHash != sourceHash
+        || header.stringsSize % 4 != 0)
+        return;
+    std::size_t materialsOffset{sizeof(header)};
+    std::size_t texturesOffset{materialsOffset + std::size_t{header.numMaterials}*sizeof(BakedMaterial)};
+    std::size_t meshesOffset{texturesOffset + std::size_t{header.numTextures}*sizeof(BakedString)};
+    std::size_t stringsOffset{meshesOffset + std::size_t{header.numMeshes}*sizeof(BakedMesh)};
+    std::size_t buffersOffset{stringsOffset + header.stringsSize};
+    if (buffersOffset > data.size())
+        return;
+    std::string_view strings{data.substr(stringsOffset, header.stringsSize)};
+
+    this->_materials.resize(header.numMaterials);
+    for (std::size_t i=0; i<header.numMaterials; ++i)
+    {
+        BakedMaterial baked;
+        read(data, materialsOffset + i*sizeof(BakedMaterial), baked);
+        MaterialData& material{this->_materials[i]};
+        if (!readString(strings, baked.name, material.name)
+            || baked.firstTexture > header.numTextures
+            || header.numTextures - baked.firstTexture < baked.numTextures)
+            return;
+        material.Ns = baked.Ns;
+        material.Ka = glm::vec3(baked.Ka[0], baked.Ka[1], baked.Ka[2]);
+        material.Kd = glm::vec3(baked.Kd[0], baked.Kd[1], baked.Kd[2]);
+        material.Ks = glm::vec3(baked.Ks[0], baked.Ks[1], baked.Ks[2]);
+        material.diffuseTextures.resize(baked.numTextures);
+        for (std::size_t j=0; j<baked.numTextures; ++j)
+        {
+            BakedString texture;
+            read(data, texturesOffset + (baked.firstTexture + j)*sizeof(BakedString), texture);
+            if (!readString(strings, texture, material.diffuseTextures[j]))
+                return;
+        }
+    }
+
+    // blocks start at multiples of 4 bytes from a page aligned mapping, 16 bit indices can leave a block
+    // 2 bytes short, GL copies from any alignment
+    std::size_t offset{buffersOffset};
+    this->_meshes.reserve(header.numMeshes);
+    for (std::size_t i=0; i<header.numMeshes; ++i)
+    {
+        BakedMesh baked;
+        read(data, meshesOffset + i*sizeof(BakedMesh), baked);
+        if (baked.material >= header.numMaterials)
+            return;
+        // also catches a bake made with or without HALF_VERTICES
+        VertexFormat format{vertexFormat(this->_materials[baked.material])};
+        if (baked.format != static_cast<std::uint32_t>(format))
+            return;
+        std::size_t verticesSize{std::size_t{baked.numVertices}*vertexStride(format)};
+        std::size_t indicesSize{std::size_t{baked.numIndices}*indexSize(baked.numVertices)};
+        if (data.size() - offset < verticesSize + indicesSize)
+            return;
+        this->_meshes.push_back(MeshView{
+            baked.material,
+            format,
+            data.data() + offset,
+            baked.numVertices,
+            data.data() + offset + verticesSize,
+            baked.numIndices
+        });
+        offset += verticesSize + indicesSize;
+    }
+    if (offset != data.size())
+        return;
+    this->_open = true;
+}
+
+bool BakedModel::isOpen() const
+{
+    return this->_open;
+}
+
+const std::vector<MaterialData>& BakedModel::materials() const
+{
+    return this->_materials;
+}
+
+const std::vector<MeshView>& BakedModel::meshes() const
+{
+    return this->_meshes;
+}
@@ -0,0 +1,87 @@
+#ifndef MESHCACHE_H
+#define MESHCACHE_H
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "mappedfile.hpp"
+#include "modeldata.hpp"
+
+// .rbm baked model layout: BakedHeader, numMaterials BakedMaterials, numTextures BakedStrings,
+// numMeshes BakedMeshes, stringsSize bytes of names and paths padded to a multiple of 4 bytes,
+// then the vertices and the indices of every mesh in order, exactly as they are uploaded.
+// written in host byte order. a mesh baked in another VertexFormat than this build picks is rebaked
+inline constexpr char BAKED_MAGIC[4]{'R', 'B', 'M', '1'};
+// version 1 stored the full 88 byte vertex, version 2 unoptimized 32 bit indices
+inline constexpr std::uint32_t BAKED_VERSION{3};
+
+struct BakedHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    // hashModelSources of the files the model was imported from
+    std::uint64_t sourceHash;
+    std::uint32_t numMaterials;
+    std::uint32_t numTextures;
+    std::uint32_t numMeshes;
+    std::uint32_t stringsSize;
+    std::uint32_t reserved[2];
+};
+
+// a name or path in the strings block
+struct BakedString
+{
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+struct BakedMaterial
+{
+    BakedString name;
+    float Ns;
+    float Ka[3];
+    float Kd[3];
+    float Ks[3];
+    // diffuse texture paths, a range of the BakedStrings after the materials
+    std::uint32_t firstTexture;
+    std::uint32_t numTextures;
+};
+
+struct BakedMesh
+{
+    std::uint32_t material;
+    std::uint32_t numVertices;
+    std::uint32_t numIndices;
+    // VertexFormat of the vertices
+    std::uint32_t format;
+};
+
+static_assert(sizeof(BakedHeader) == 40);
+static_assert(sizeof(BakedString) == 8);
+static_assert(sizeof(BakedMaterial) == 56);
+static_assert(sizeof(BakedMesh) == 16);
+
+// content hash of the model file and the .mtl files next to it, which is where obj keeps its materials
+std::uint64_t hashModelSources(const std::string& path);
+// where the baked copy of the model at path lives
+std::string bakedModelPath(const std::string& path);
+// false if the file couldn't be written. it is written aside and renamed, readers never see half a bake
+bool saveBakedModel(const ModelData& model, std::uint64_t sourceHash, const std::string& bakedFile);
+
+// a baked model mapped into memory, meshes point into the mapping
+class BakedModel
+{
+public:
+    // isOpen is false when the file is missing, malformed or baked from other sources than sourceHash
+    BakedModel(const std::string& bakedFile, std::uint64_t sourceHash);
+    bool isOpen() const;
+    const std::vector<MaterialData>& materials() const;
+    const std::vector<MeshView>& meshes() const;
+private:
+    MappedFile _file;
+    std::vector<MaterialData> _materials;
+    std::vector<MeshView> _meshes;
+    bool _open{false};
+};
+
+#endif
@@ -0,0 +1,285 @@
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+
+#include "meshopt.hpp"
+
+namespace
+{
+
+// scoring constants from Forsyth's paper
+constexpr float CACHE_DECAY_POWER{1.5f};
+constexpr float LAST_TRIANGLE_SCORE{0.75f};
+constexpr float VALENCE_BOOST_SCALE{2.0f};
+constexpr float VALENCE_BOOST_POWER{0.5f};
+
+// how much emitting a triangle that uses the vertex now is worth
+float vertexScore(int cachePosition, unsigned int remainingTriangles)
+{
+    if (remainingTriangles == 0)
+        return -1.0f;
+    float score{0.0f};
+    if (cachePosition >= 0)
+    {
+        // the last triangle's vertices score the same, whichever order they were sent in
+        if (cachePosition < 3)
+            score = LAST_TRIANGLE_SCORE;
+        else
+            score = std::pow(1.0f - static_cast<float>(cachePosition - 3) / (VERTEX_CACHE_SIZE - 3), CACHE_DECAY_POWER);
+    }
+    // vertices with few triangles left are worth finishing off
+    return score + VALENCE_BOOST_SCALE * std::pow(static_cast<float>(remainingTriangles), -VALENCE_BOOST_POWER);
+}
+
+// FIFO cache of vertices, as the hardware keeps them
+class VertexCache
+{
+public:
+    VertexCache(std::size_t numVertices, std::size_t size)
+    : _stamps(numVertices, 0)
+    , _size{size}
+    {
+    }
+    // false on a miss, which also loads vertex
+    bool hit(unsigned int vertex)
+    {
+        // a vertex is cached while fewer than size misses came after its own
+        if (this->_stamps[vertex] != 0 && this->_misses - this->_stamps[vertex] < this->_size)
+            return true;
+        this->_stamps[vertex] = ++this->_misses;
+        return false;
+    }
+    std::size_t misses() const
+    {
+        return this->_misses;
+    }
+private:
+    // miss count when each vertex was loaded, 0 if never
+    std::vector<std::size_t> _stamps;
+    std::size_t _size;
+    std::size_t _misses{0};
+};
+
+std::size_t maxIndex(const std::vector<unsigned int>& indices)
+{
+    return indices.empty() ? 0 : *std::max_element(indices.begin(), indices.end()) + 1;
+}
+
+}
+
+void weldVertices(std::vector<char>& vertices, std::size_t stride, std::vector<unsigned int>& indices)
+{
+    std::size_t numVertices{vertices.size()/stride};
+    std::vector<unsigned int> remap(numVertices);
+    std::vector<char> welded;
+    welded.reserve(vertices.size());
+    // keys view the original vertices, which stay untouched until the end
+    std::unordered_map<std::string_view, unsigned int> firstVertex;
+    firstVertex.reserve(numVertices);
+    for (std::size_t vertex=0; vertex<numVertices; ++vertex)
+    {
+        std::string_view bytes{&vertices[vertex*stride], stride};
+        auto [found, added] = firstVertex.emplace(bytes, static_cast<unsigned int>(welded.size()/stride));
+        if (added)
+            welded.insert(welded.end(), bytes.begin(), bytes.end());
+        remap[vertex] = found->second;
+    }
+    for (unsigned int& index : indices)
+        index = remap[index];
+    vertices = std::move(welded);
+}
+
+void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t numVertices)
+{
+    std::size_t numTriangles{indices.size()/3};
+    if (numTriangles == 0)
+        return;
+    // triangles using each vertex, vertex v's are at triangles[offsets[v]] onwards, remaining[v] of them not emitted
+    std::vector<unsigned int> offsets(numVertices + 1, 0);
+    for (unsigned int index : indices)
+        ++offsets[index + 1];
+    for (std::size_t vertex=0; vertex<numVertices; ++vertex)
+        offsets[vertex + 1] += offsets[vertex];
+    std::vector<unsigned int> remaining(numVertices, 0);
+    std::vector<unsigned int> triangles(indices.size());
+    for (std::size_t triangle=0; triangle<numTriangles; ++triangle)
+        for (std::size_t corner=0; corner<3; ++corner)
+        {
+            unsigned int vertex{indices[3*triangle + corner]};
+            triangles[offsets[vertex] + remaining[vertex]++] = static_cast<unsigned int>(triangle);
+        }
+
+    std::vector<int> cachePosition(numVertices, -1);
+    std::vector<float> scores(numVertices);
+    for (std::size_t vertex=0; vertex<numVertices; ++vertex)
+        scores[vertex] = vertexScore(-1, remaining[vertex]);
+    std::vector<float> triangleScores(numTriangles);
+    std::vector<bool> emitted(numTriangles, false);
+    for (std::size_t triangle=0; triangle<numTriangles; ++triangle)
+        triangleScores[triangle] = scores[indices[3*triangle]] + scores[indices[3*triangle + 1]] + scores[indices[3*triangle + 2]];
+
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    // LRU order, the 3 extra entries hold vertices pushed out by the triangle just emitted
+    std::vector<unsigned int> cache;
+    std::vector<unsigned int> nextCache;
+    std::size_t best{static_cast<std::size_t>(std::max_element(triangleScores.begin(), triangleScores.end()) - triangleScores.begin())};
+    // when no cached vertex has triangles left, the next start is the first triangle not emitted yet
+    std::size_t cursor{0};
+    while (result.size() < indices.size())
+    {
+        if (best == numTriangles)
+        {
+            while (emitted[cursor])
+                ++cursor;
+            best = cursor;
+        }
+        emitted[best] = true;
+        nextCache.clear();
+        for (std::size_t corner=0; corner<3; ++corner)
+        {
+            unsigned int vertex{indices[3*best + corner]};
+            result.push_back(vertex);
+            nextCache.push_back(vertex);
+            // drop the triangle from the vertex's list
+            unsigned int* begin{&triangles[offsets[vertex]]};
+            unsigned int* end{begin + remaining[vertex]};
+            std::iter_swap(std::find(begin, end, static_cast<unsigned int>(best)), end - 1);
+            --remaining[vertex];
+        }
+        for (unsigned int vertex : cache)
+            if (std::find(nextCache.begin(), nextCache.begin() + 3, vertex) == nextCache.begin() + 3)
+                nextCache.push_back(vertex);
+        std::swap(cache, nextCache);
+        // rescore everything that was or is in the cache, then the triangles around it
+        for (std::size_t position=0; position<cache.size(); ++position)
+        {
+            unsigned int vertex{cache[position]};
+            cachePosition[vertex] = position < VERTEX_CACHE_SIZE ? static_cast<int>(position) : -1;
+            scores[vertex] = vertexScore(cachePosition[vertex], remaining[vertex]);
+        }
+        best = numTriangles;
+        float bestScore{-1.0f};
+        for (unsigned int vertex : cache)
+            for (unsigned int i=0; i<remaining[vertex]; ++i)
+            {
+                unsigned int triangle{triangles[offsets[vertex] + i]};
+                float score{scores[indices[3*triangle]] + scores[indices[3*triangle + 1]] + scores[indices[3*triangle + 2]]};
+                if (score > bestScore)
+                {
+                    bestScore = score;
+                    best = triangle;
+                }
+            }
+        if (cache.size() > VERTEX_CACHE_SIZE)
+            cache.resize(VERTEX_CACHE_SIZE);
+    }
+    indices = std::move(result);
+}
+
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions)
+{
+    std::size_t numTriangles{indices.size()/3};
+    if (numTriangles == 0 || positions.size() < maxIndex(indices))
+        return;
+    // a cluster starts wherever all three vertices miss. later triangles may still hit vertices of the
+    // cluster before, those hits are lost when the clusters move apart
+    std::vector<std::size_t> starts;
+    VertexCache cache(positions.size(), VERTEX_CACHE_SIZE);
+    for (std::size_t triangle=0; triangle<numTriangles; ++triangle)
+    {
+        bool hit{false};
+        for (std::size_t corner=0; corner<3; ++corner)
+            hit = cache.hit(indices[3*triangle + corner]) || hit;
+        if (!hit)
+            starts.push_back(triangle);
+    }
+    starts.push_back(numTriangles);
+
+    auto triangleArea{[&](std::size_t triangle) {
+        const glm::vec3& a{positions[indices[3*triangle]]};
+        const glm::vec3& b{positions[indices[3*triangle + 1]]};
+        const glm::vec3& c{positions[indices[3*triangle + 2]]};
+        // twice the area, pointing out of the front face
+        return glm::cross(b - a, c - a);
+    }};
+    auto triangleCenter{[&](std::size_t triangle) {
+        return (positions[indices[3*triangle]] + positions[indices[3*triangle + 1]] + positions[indices[3*triangle + 2]]) / 3.0f;
+    }};
+    // area weighted center of the mesh
+    glm::vec3 meshCenter{0.0f};
+    float meshArea{0.0f};
+    for (std::size_t triangle=0; triangle<numTriangles; ++triangle)
+    {
+        float area{glm::length(triangleArea(triangle))};
+        meshCenter += area * triangleCenter(triangle);
+        meshArea += area;
+    }
+    if (meshArea > 0.0f)
+        meshCenter /= meshArea;
+
+    // how far out of the mesh a cluster faces, the ones facing out hide the ones facing in
+    std::size_t numClusters{starts.size() - 1};
+    std::vector<float> facing(numClusters, 0.0f);
+    for (std::size_t cluster=0; cluster<numClusters; ++cluster)
+    {
+        glm::vec3 normal{0.0f};
+        glm::vec3 center{0.0f};
+        float area{0.0f};
+        for (std::size_t triangle=starts[cluster]; triangle<starts[cluster + 1]; ++triangle)
+        {
+            glm::vec3 areaNormal{triangleArea(triangle)};
+            normal += areaNormal;
+            center += glm::length(areaNormal) * triangleCenter(triangle);
+            area += glm::length(areaNormal);
+        }
+        if (area > 0.0f && glm::length(normal) > 0.0f)
+            facing[cluster] = glm::dot(center / area - meshCenter, glm::normalize(normal));
+    }
+    std::vector<std::size_t> order(numClusters);
+    for (std::size_t cluster=0; cluster<numClusters; ++cluster)
+        order[cluster] = cluster;
+    std::stable_sort(order.begin(), order.end(), [&facing](std::size_t a, std::size_t b) {
+        return facing[a] > facing[b];
+    });
+    std::vector<unsigned int> result;
+    result.reserve(indices.size());
+    for (std::size_t cluster : order)
+        result.insert(result.end(), indices.begin() + 3*starts[cluster], indices.begin() + 3*starts[cluster + 1]);
+    if (averageCacheMissRatio(result, VERTEX_CACHE_SIZE) > OVERDRAW_THRESHOLD*averageCacheMissRatio(indices, VERTEX_CACHE_SIZE))
+        return;
+    indices = std::move(result);
+}
+
+void optimizeVertexFetch(std::vector<char>& vertices, std::size_t stride, std::vector<unsigned int>& indices)
+{
+    constexpr unsigned int UNUSED{~0u};
+    std::vector<unsigned int> remap(vertices.size()/stride, UNUSED);
+    std::vector<char> fetched;
+    fetched.reserve(vertices.size());
+    for (unsigned int& index : indices)
+    {
+        if (remap[index] == UNUSED)
+        {
+            remap[index] = static_cast<unsigned int>(fetched.size()/stride);
+            fetched.insert(fetched.end(), vertices.begin() + index*stride, vertices.begin() + (index + 1)*stride);
+        }
+        index = remap[index];
+    }
+    vertices = std::move(fetched);
+}
+
+double averageCacheMissRatio(const std::vector<unsigned int>& indices, std::size_t cacheSize)
+{
+    std::size_t numTriangles{indices.size()/3};
+    if (numTriangles == 0)
+        return 0.0;
+    VertexCache cache(maxIndex(indices), cacheSize);
+    for (unsigned int index : indices)
+        cache.hit(index);
+    return static_cast<double>(cache.misses()) / numTriangles;
+}
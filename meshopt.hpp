@@ -0,0 +1,31 @@
+#ifndef MESHOPT_H
+#define MESHOPT_H
+#include <cstddef>
+#include <vector>
+#include <glm/glm.hpp>
+
+// index buffer passes on triangle lists, vertices are opaque blocks of stride bytes.
+// run in this order, each pass keeps what the ones before it gained
+
+// post-transform cache size the passes optimize for and ACMR is reported with
+inline constexpr std::size_t VERTEX_CACHE_SIZE{16};
+
+// how much worse optimizeOverdraw may make the ACMR, as a factor, before it keeps the cache order
+inline constexpr double OVERDRAW_THRESHOLD{1.05};
+
+// merge vertices with the same bytes, importers write one vertex per triangle corner
+void weldVertices(std::vector<char>& vertices, std::size_t stride, std::vector<unsigned int>& indices);
+// order triangles so vertices are reused while they are still in the post-transform cache,
+// Tom Forsyth's linear-speed vertex cache optimization
+void optimizeVertexCache(std::vector<unsigned int>& indices, std::size_t numVertices);
+// split the triangles where the cache starts over and draw the clusters facing out of the mesh first,
+// so fewer hidden fragments get shaded. the order inside each cluster is kept, but vertices a cluster shared
+// with the one before it miss again once they are apart, so this trades some cache efficiency for less overdraw.
+// the triangles stay as they were if the ACMR would grow by more than OVERDRAW_THRESHOLD
+void optimizeOverdraw(std::vector<unsigned int>& indices, const std::vector<glm::vec3>& positions);
+// renumber vertices in the order they are first used, dropping unused ones
+void optimizeVertexFetch(std::vector<char>& vertices, std::size_t stride, std::vector<unsigned int>& indices);
+// average cache misses per triangle of a FIFO cache of cacheSize vertices, 3 is the worst and 0.5 about the best
+double averageCacheMissRatio(const std::vector<unsigned int>& indices, std::size_t cacheSize);
+
+#endif
@@ -1,34 +1,27 @@
 #include <string>
 #include <iostream>
 #include <vector>
-#include <cmath>
+#include <iterator>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <unordered_map>
+#include <utility>
 #include <glad/glad.h> 
 #include <glm/glm.hpp>
-#include <assimp/Importer.hpp>
-#include <assimp/scene.h>
-#include <assimp/postprocess.h>
 
-#include "stb_image.h"
 #include "shader.hpp"
 #include "model.hpp"
+#include "meshcache.hpp"
+#include "parallel.hpp"
 
-std::ostream& operator<<(std::ostream& os, Orientation o) 
-{
-    switch (o) {
-        case Orientation::UP:   return os << "UP";
-        case Orientation::DOWN: return os << "DOWN";
-        case Orientation::LEFT:  return os << "LEFT";
-        case Orientation::RIGHT:  return os << "RIGHT";
-    }
-    return os << "Unknown";
-}
-
-// copy from arguments
-Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, Material* material)
-: vertices{vertices}
-, indices{indices}
+Mesh::Mesh(const MeshView& view, Material* material)
+: _numIndices{static_cast<unsigned int>(view.numIndices)}
+, _indexType{static_cast<GLenum>(indexSize(view.numVertices) == sizeof(std::uint16_t) ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT)}
 , _material{material}
 {
+    std::size_t stride{vertexStride(view.format)};
+    GLenum type = halfFloats(view.format) ? GL_HALF_FLOAT : GL_FLOAT;
     // create buffers
     glGenVertexArrays(1, &this->VAO);
     glGenBuffers(1, &this->VBO);
@@ -36,73 +29,60 @@ Mesh::Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, Ma
     // load data into vertex buffers
     glBindVertexArray(this->VAO);
     glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(Vertex), &this->vertices[0], GL_STATIC_DRAW);  
+    glBufferData(GL_ARRAY_BUFFER, view.numVertices * stride, view.vertices, GL_STATIC_DRAW);  
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->indices.size() * sizeof(unsigned int), &this->indices[0], GL_STATIC_DRAW);
-    // set the vertex attribute pointers
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, view.numIndices * indexSize(view.numVertices), view.indices, GL_STATIC_DRAW);
+    // set the vertex attribute pointers, the same locations the shaders read
     // vertex Positions
     glEnableVertexAttribArray(0);	
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    // vertex normals
-    glEnableVertexAttribArray(1);	
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
+    glVertexAttribPointer(0, 3, type, GL_FALSE, stride, (void*)0);
     // vertex texture coords
-    glEnableVertexAttribArray(2);	
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-    // vertex tangent
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-    // vertex bitangent
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
-    // ids
-    glEnableVertexAttribArray(5);
-    glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-    // weights
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, boneWeights));
+    if (texCoordsOffset(view.format) > 0)
+    {
+        glEnableVertexAttribArray(2);	
+        glVertexAttribPointer(2, 2, type, GL_FALSE, stride, (void*)texCoordsOffset(view.format));
+    }
     glBindVertexArray(0);
 }
 
-// move from arguments
-Mesh::Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, Material* material)
-: vertices{std::move(vertices)}
-, indices{std::move(indices)}
-, _material{material}
+Mesh::~Mesh()
 {
-    // create buffers
-    glGenVertexArrays(1, &this->VAO);
-    glGenBuffers(1, &this->VBO);
-    glGenBuffers(1, &this->EBO);
-    // load data into vertex buffers
-    glBindVertexArray(this->VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, this->VBO);
-    glBufferData(GL_ARRAY_BUFFER, this->vertices.size() * sizeof(Vertex), &this->vertices[0], GL_STATIC_DRAW);  
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, this->EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, this->indices.size() * sizeof(unsigned int), &this->indices[0], GL_STATIC_DRAW);
-    // set the vertex attribute pointers
-    // vertex Positions
-    glEnableVertexAttribArray(0);	
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)0);
-    // vertex normals
-    glEnableVertexAttribArray(1);	
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, normal));
-    // vertex texture coords
-    glEnableVertexAttribArray(2);	
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, texCoords));
-    // vertex tangent
-    glEnableVertexAttribArray(3);
-    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, tangent));
-    // vertex bitangent
-    glEnableVertexAttribArray(4);
-    glVertexAttribPointer(4, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, bitangent));
-    // ids
-    glEnableVertexAttribArray(5);
-    glVertexAttribIPointer(5, 4, GL_INT, sizeof(Vertex), (void*)offsetof(Vertex, boneIDs));
-    // weights
-    glEnableVertexAttribArray(6);
-    glVertexAttribPointer(6, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*)offsetof(Vertex, boneWeights));
-    glBindVertexArray(0);
+    this->_deleteBuffers();
+}
+
+Mesh::Mesh(Mesh&& mesh) noexcept
+: VAO{std::exchange(mesh.VAO, 0)}
+, VBO{std::exchange(mesh.VBO, 0)}
+, EBO{std::exchange(mesh.EBO, 0)}
+, _numIndices{mesh._numIndices}
+, _indexType{mesh._indexType}
+, _material{mesh._material}
+{
+}
+
+Mesh& Mesh::operator=(Mesh&& mesh) noexcept
+{
+    if (this != &mesh)
+    {
+        this->_deleteBuffers();
+        this->VAO = std::exchange(mesh.VAO, 0);
+        this->VBO = std::exchange(mesh.VBO, 0);
+        this->EBO = std::exchange(mesh.EBO, 0);
+        this->_numIndices = mesh._numIndices;
+        this->_indexType = mesh._indexType;
+        this->_material = mesh._material;
+    }
+    return *this;
+}
+
+void Mesh::_deleteBuffers()
+{
+    if (this->VAO != 0)
+        glDeleteVertexArrays(1, &this->VAO);
+    if (this->VBO != 0)
+        glDeleteBuffers(1, &this->VBO);
+    if (this->EBO != 0)
+        glDeleteBuffers(1, &this->EBO);
 }
 
 Material* Mesh::material() const
@@ -114,59 +94,34 @@ void Mesh::draw() const
 {           
     // draw mesh
     glBindVertexArray(this->VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<unsigned int>(this->indices.size()), GL_UNSIGNED_INT, 0);
+    glDrawElements(GL_TRIANGLES, this->_numIndices, this->_indexType, 0);
     // always good practice to set everything back to defaults once configured.
     glBindVertexArray(0);
 };
 
+void Mesh::drawInstanced(unsigned int count) const
+{
+    glBindVertexArray(this->VAO);
+    glDrawElementsInstanced(GL_TRIANGLES, this->_numIndices, this->_indexType, 0, count);
+    glBindVertexArray(0);
+}
+
 Model::Model(
-    std::vector<Material>& materials, 
-    std::vector<Mesh>& meshes, 
-    std::string& directory,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
+    std::shared_ptr<const ModelAsset> asset,
     const glm::mat4& modelMatrix
 )
-: _materials{materials}
-, _meshes{meshes}
-, _directory{directory}
-, _projectionMatrix{projectionMatrix}
-, _viewMatrix{viewMatrix}
+: _asset{std::move(asset)}
 , _modelMatrix{modelMatrix}
 {
 };
 
 Model::Model(
     const std::string& path,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
     const glm::mat4& modelMatrix
 )
-: _projectionMatrix{projectionMatrix}
-, _viewMatrix{viewMatrix}
+: _asset{loadModelAsset(path)}
 , _modelMatrix{modelMatrix}
 {
-    _loadModel(path);
-};
-
-const glm::mat4& Model::projectionMatrix() const
-{
-    return this->_projectionMatrix;
-};
-
-void Model::setProjectionMatrix(const glm::mat4& projectionTransform)
-{
-    this->_projectionMatrix = projectionTransform;
-};
-
-const glm::mat4& Model::viewMatrix() const
-{
-    return this->_viewMatrix;
-};
-
-void Model::setViewMatrix(const glm::mat4& viewTransform)
-{
-    this->_viewMatrix = viewTransform;
 };
 
 const glm::mat4& Model::modelMatrix() const
@@ -179,379 +134,281 @@ void Model::setModelMatrix(const glm::mat4& modelTransform)
     this->_modelMatrix = modelTransform;
 };
 
-void Model::translate(const glm::vec3& vector)
-{
-    this->_modelMatrix = glm::translate(this->_modelMatrix, vector);
-}
-void Model::rotate(float angle, const glm::vec3& axis)
+
+ModelAsset::~ModelAsset()
 {
-    this->_modelMatrix = glm::rotate(this->_modelMatrix, angle, axis);
+    for (const Material& material : this->materials)
+        for (unsigned int texture : material.diffuseTextures)
+            releaseTexture(texture);
 }
 
-void Model::_loadModel(const std::string& path)
+namespace
 {
-    // read file via ASSIMP
-    Assimp::Importer importer;
-    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_GenSmoothNormals | aiProcess_FlipUVs | aiProcess_CalcTangentSpace);
-    // check for errors
-    if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
-    {
-        std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
-        return;
-    };
-    // retrieve the directory path of the filepath
-    this->_directory = path.substr(0, path.find_last_of('/'));
-    this->_materials = this->_setupMaterials(scene);
-    for(unsigned int i = 0; i < scene->mNumMeshes; i++)
-    {   
-        aiMesh* mesh{scene->mMeshes[i]};
-        _meshes.emplace_back(setupVertices(mesh), setupIndices(mesh), &this->_materials[mesh->mMaterialIndex]);
-    };
-};
 
-std::vector<Material> Model::_setupMaterials(const aiScene* aiscene)
-{   
-    // data to fill
-    std::vector<Material> materials(aiscene->mNumMaterials);
-    for (unsigned int i=0; i<aiscene->mNumMaterials; ++i)
-    {
-        Material* material{&materials[i]};
-        aiMaterial* aiMaterial{aiscene->mMaterials[i]};
-        aiColor3D ambient;
-        aiColor3D diffuse;
-        aiColor3D specular;
-        float shininess;
-        material->name = aiMaterial->GetName().C_Str();
-        // Ambient color
-        if (aiMaterial->Get(AI_MATKEY_COLOR_AMBIENT, ambient) == AI_SUCCESS) {
-            material->Ka.x=ambient.r;
-            material->Ka.y=ambient.b;
-            material->Ka.z=ambient.g;
-        };
-        // Diffuse color
-        if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) == AI_SUCCESS) {
-            material->Kd.x=diffuse.r;
-            material->Kd.y=diffuse.b;
-            material->Kd.z=diffuse.g;
-        };
-        // Specular color
-        if (aiMaterial->Get(AI_MATKEY_COLOR_SPECULAR, specular) == AI_SUCCESS) {
-            material->Ks.x=specular.r;
-            material->Ks.y=specular.b;
-            material->Ks.z=specular.g;
-        };
-        // Shininess (Specular exponent)
-        if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
-            material->Ns=shininess;
-        };
-        // Diffuse textures
-        material->diffuseTextures=this->_setupTextures(aiMaterial, aiTextureType_DIFFUSE);
-    };
-    return materials;
+// everything loading a model needs before touching GL, made on any thread
+struct PreparedModel
+{
+    std::string directory;
+    // whichever the meshes point into
+    std::unique_ptr<BakedModel> baked;
+    std::optional<ModelData> data;
+    std::vector<MaterialData> materials;
+    std::vector<MeshView> meshes;
 };
 
-std::vector<unsigned int> Model::_setupTextures(aiMaterial *mat, aiTextureType type)
+PreparedModel prepareModel(const std::string& path)
 {
-    std::vector<unsigned int> textures;
-    for(unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+    PreparedModel prepared;
+    // retrieve the directory path of the filepath
+    prepared.directory = path.substr(0, path.find_last_of('/'));
+    std::uint64_t sourceHash{hashModelSources(path)};
+    std::string bakedPath{bakedModelPath(path)};
+    prepared.baked = std::make_unique<BakedModel>(bakedPath, sourceHash);
+    if (prepared.baked->isOpen())
     {
-        aiString str;
-        mat->GetTexture(type, i, &str);
-        textures.push_back(textureFromFile(str.C_Str(), this->_directory));
-    };
-    return textures;
-};
+        // buffers go to the GPU straight from the mapped file
+        prepared.materials = prepared.baked->materials();
+        prepared.meshes = prepared.baked->meshes();
+        return prepared;
+    }
+    prepared.baked.reset();
+    // first run, or the model changed since it was baked
+    prepared.data = importModel(path);
+    if (!prepared.data)
+        return prepared;
+    for (MeshData& mesh : prepared.data->meshes)
+        optimizeMesh(mesh);
+    if (!saveBakedModel(*prepared.data, sourceHash, bakedPath))
+        std::cout << "Failed to bake model " << path << std::endl;
+    prepared.materials = prepared.data->materials;
+    for (const MeshData& mesh : prepared.data->meshes)
+        prepared.meshes.push_back(mesh.view());
+    return prepared;
+}
 
-std::vector<Vertex> setupVertices(aiMesh* mesh)
+// upload meshes and load the textures of materials into asset, decoded images by texturePath are used
+// instead of reading the files
+void setupAsset(ModelAsset& asset, const PreparedModel& prepared, const std::unordered_map<std::string, Image>& images)
 {
-    // data to fill
-    std::vector<Vertex> vertices(mesh->mNumVertices);
-    // walk through each of the mesh's vertices
-    for(unsigned int i = 0; i < mesh->mNumVertices; i++)
+    asset.directory = prepared.directory;
+    asset.materials.reserve(prepared.materials.size());
+    for (const MaterialData& data : prepared.materials)
     {
-        Vertex* vertex{&vertices[i]};
-        // positions
-        aiVector3D* aiVertices{mesh->mVertices};
-        vertex->position.x = aiVertices[i].x;
-        vertex->position.y = aiVertices[i].y;
-        vertex->position.z = aiVertices[i].z;
-        // normals
-        if (mesh->HasNormals())
+        std::vector<unsigned int> textures;
+        for (const std::string& texture : data.diffuseTextures)
         {
-            aiVector3D* aiNormals{mesh->mNormals};
-            vertex->normal.x = aiNormals[i].x;
-            vertex->normal.y = aiNormals[i].y;
-            vertex->normal.z = aiNormals[i].z;
-        };
-        // texture coordinates
-        if(mesh->mTextureCoords[0]) // does the mesh contain texture coordinates?
-        {
-            glm::vec2 vec;
-            // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't 
-            // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
-            aiVector3D* aiTextureCoords_0{mesh->mTextureCoords[0]};
-            vertex->texCoords.x = aiTextureCoords_0[i].x;
-            vertex->texCoords.y = aiTextureCoords_0[i].y;
-            // tangent
-            aiVector3D* aiTangent{mesh->mTangents};
-            vertex->tangent.x = aiTangent[i].x;
-            vertex->tangent.y = aiTangent[i].y;
-            vertex->tangent.z = aiTangent[i].z;
-            // bitangent
-            aiVector3D* aiBitangent{mesh->mBitangents};
-            vertex->bitangent.x = aiBitangent[i].x;
-            vertex->bitangent.y = aiBitangent[i].y;
-            vertex->bitangent.z = aiBitangent[i].z;
-        };
-    };
-    return vertices;
-};
+            auto image{images.find(texturePath(texture.c_str(), asset.directory))};
+            textures.push_back(acquireTexture(texture.c_str(), asset.directory, image == images.end() ? nullptr : &image->second));
+        }
+        asset.materials.push_back(Material{data.name, data.Ns, data.Ka, data.Kd, data.Ks, std::move(textures)});
+    }
+    asset.meshes.reserve(prepared.meshes.size());
+    for (const MeshView& mesh : prepared.meshes)
+        asset.meshes.emplace_back(mesh, &asset.materials[mesh.material]);
+}
 
-std::vector<unsigned int> setupIndices(aiMesh* mesh)
-{
-    std::vector<unsigned int> indices;
-    for(unsigned int i = 0; i < mesh->mNumFaces; ++i)
-    {
-        aiFace* face = mesh->mFaces;
-        for(unsigned int j = 0; j < face[i].mNumIndices; ++j)
-            indices.push_back(face[i].mIndices[j]);        
-    };
-    return indices;
-};
+// every forklift is the same file, import it and upload its buffers once.
+// assets go away with their last model, while the GL context is still there to free textures
+std::unordered_map<std::string, std::weak_ptr<const ModelAsset>> assetCache;
 
-unsigned int textureFromFile(const char *path, const std::string& directory)
+std::string assetKey(const std::string& path)
 {
-    std::string filename = std::string(path);
-    filename = directory + '/' + filename;
+    return std::filesystem::path(path).lexically_normal().string();
+}
+
+}
 
-    unsigned int textureID;
-    glGenTextures(1, &textureID);
+std::shared_ptr<const ModelAsset> loadModelAsset(const std::string& path)
+{
+    return loadModelAssets({path}).front();
+};
 
-    int width, height, nrComponents;
-    unsigned char *data = stbi_load(filename.c_str(), &width, &height, &nrComponents, 0);
-    if (data)
+std::vector<std::shared_ptr<const ModelAsset>> loadModelAssets(const std::vector<std::string>& paths)
+{
+    std::vector<std::shared_ptr<const ModelAsset>> assets(paths.size());
+    // paths not loaded yet, each once
+    std::vector<std::string> missing;
+    std::unordered_map<std::string, std::size_t> missingIndex;
+    for (std::size_t i=0; i<paths.size(); ++i)
     {
-        GLenum format;
-        if (nrComponents == 1)
-            format = GL_RED;
-        else if (nrComponents == 3)
-            format = GL_RGB;
-        else if (nrComponents == 4)
-            format = GL_RGBA;
-
-        glBindTexture(GL_TEXTURE_2D, textureID);
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
-
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-        stbi_image_free(data);
+        std::string key{assetKey(paths[i])};
+        assets[i] = assetCache[key].lock();
+        if (!assets[i] && missingIndex.emplace(key, missing.size()).second)
+            missing.push_back(paths[i]);
     }
-    else
+    // cpu stage, models and then their textures spread over every core
+    std::vector<PreparedModel> prepared(missing.size());
+    parallelFor(missing.size(), [&](std::size_t i) {
+        prepared[i] = prepareModel(missing[i]);
+    });
+    std::unordered_map<std::string, Image> images;
+    for (const PreparedModel& model : prepared)
+        for (const MaterialData& material : model.materials)
+            for (const std::string& texture : material.diffuseTextures)
+                images.emplace(texturePath(texture.c_str(), model.directory), Image{});
+    std::vector<std::pair<const std::string, Image>*> decodes;
+    for (auto& image : images)
+        decodes.push_back(&image);
+    parallelFor(decodes.size(), [&](std::size_t i) {
+        decodes[i]->second = decodeImage(decodes[i]->first);
+    });
+    // gl stage, on this thread
+    std::vector<std::shared_ptr<ModelAsset>> uploaded(missing.size());
+    for (std::size_t i=0; i<missing.size(); ++i)
     {
-        std::cout << "Texture failed to load at path: " << path << std::endl;
-        stbi_image_free(data);
-    };
-
-    return textureID;
-};
+        uploaded[i] = std::make_shared<ModelAsset>();
+        // a file that fails to import stays cached empty, so the error is printed once per use
+        setupAsset(*uploaded[i], prepared[i], images);
+        assetCache[assetKey(missing[i])] = uploaded[i];
+    }
+    for (std::size_t i=0; i<paths.size(); ++i)
+        if (!assets[i])
+            assets[i] = uploaded[missingIndex[assetKey(paths[i])]];
+    return assets;
+}
 
 Forklift::Forklift(
-    std::vector<Material>& materials, 
-    std::vector<Mesh>& meshes, 
-    std::string& directory,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
-    const glm::mat4& modelMatrix,
-    unsigned int x,
-    unsigned int y,
-    glm::vec3 color
+    std::shared_ptr<const ModelAsset> asset,
+    const glm::mat4& modelMatrix
 )
-: Model(materials, meshes, directory, projectionMatrix, viewMatrix, modelMatrix)
-, _x{x}
-, _y{y}
-, _color{color}
+: Model(std::move(asset), modelMatrix)
 {
 }
 
 Forklift::Forklift(
     const std::string& path,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
-    const glm::mat4& modelMatrix,
-    unsigned int x,
-    unsigned int y,
-    glm::vec3 color
+    const glm::mat4& modelMatrix
 )
-: Model(path, projectionMatrix, viewMatrix, modelMatrix)
-, _x{x}
-, _y{y}
-, _color{color}
+: Model(path, modelMatrix)
 {
     
 }
 
-Forklift::Forklift(const Forklift& forklift)
-: Model{forklift}
-, _x{forklift._x}
-, _y{forklift._y}
-, _orient{forklift._orient}
-, _color{forklift._color}
+void Forklift::draw(const Shader& shader, unsigned int count) const
 {
-    if (forklift._box) {
-        this->_box = std::make_unique<Box>(*forklift._box);
-    } else {
-        this->_box = nullptr;  
-    }
-}
-Forklift& Forklift::operator=(const Forklift& forklift)
-{
-    if (this != &forklift) {
-        Model::operator=(forklift);
-        this->_x = forklift._x;
-        this->_y = forklift._y;
-        this->_orient = forklift._orient;
-        this->_color = forklift._color;
-        if (forklift._box) {
-            this->_box = std::make_unique<Box>(*forklift._box);
-        } else {
-            this->_box = nullptr;  
-        }
+    shader.use();
+    // the same light for every mesh
+    shader.setVec3(UNIFORM_LIGHT_AMBIENT, 1.0, 1.0, 1.0);
+    shader.setVec3(UNIFORM_LIGHT_DIFFUSE, 1.0, 1.0, 1.0);
+    shader.setVec3(UNIFORM_LIGHT_SPECULAR, 1.0, 1.0, 1.0);
+    for(const Mesh& mesh: this->_asset->meshes)
+    {
+        shader.setVec3(UNIFORM_MATERIAL_AMBIENT, mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
+        shader.setVec3(UNIFORM_MATERIAL_DIFFUSE, mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
+        // the yellow parts take the player color from the palette
+        shader.setBool(UNIFORM_PLAYER_COLORED, mesh.material()->name == "geel1");
+        shader.setVec3(UNIFORM_MATERIAL_SPECULAR, mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
+        shader.setFloat(UNIFORM_MATERIAL_SHININESS, mesh.material()->Ns);
+        mesh.drawInstanced(count);
     }
-    return *this;
-}
-
-void Forklift::setX(unsigned int x)
-{
-    this->_x = x;
-}
-
-void Forklift::setY(unsigned int y)
-{
-    this->_y = y;
-}
-
-unsigned int Forklift::x() const
-{
-    return this->_x;
-}
-
-unsigned int Forklift::y() const
-{
-    return this->_y;
 }
 
-Orientation Forklift::orientation() const
-{
-    return this->_orient;
+ForkliftFleet::ForkliftFleet(
+    const std::string& path,
+    const std::vector<unsigned int>& players
+)
+: _forklift{path, glm::mat4(1.0f)}
+, _moved{true}
+{
+    for (unsigned int player : players)
+        this->_instances.push_back(ForkliftInstance{glm::mat4(1.0f), player, {0, 0, 0}});
+    glGenBuffers(1, &this->_instanceBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->_instanceBuffer);
+    glBufferData(GL_SHADER_STORAGE_BUFFER, this->_instances.size() * sizeof(ForkliftInstance), nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 }
 
-const glm::vec3& Forklift::color() const
+ForkliftFleet::~ForkliftFleet()
 {
-    return this->_color;
+    if (this->_instanceBuffer != 0)
+        glDeleteBuffers(1, &this->_instanceBuffer);
 }
 
-void Forklift::setOrientation(Orientation orient)
+ForkliftFleet::ForkliftFleet(ForkliftFleet&& fleet) noexcept
+: _forklift{std::move(fleet._forklift)}
+, _instances{std::move(fleet._instances)}
+, _instanceBuffer{std::exchange(fleet._instanceBuffer, 0)}
+, _moved{fleet._moved}
 {
-    this->_orient = orient;
 }
 
-const std::unique_ptr<Box>& Forklift::box() const
+ForkliftFleet& ForkliftFleet::operator=(ForkliftFleet&& fleet) noexcept
 {
-    return this->_box;
+    if (this != &fleet)
+    {
+        if (this->_instanceBuffer != 0)
+            glDeleteBuffers(1, &this->_instanceBuffer);
+        this->_forklift = std::move(fleet._forklift);
+        this->_instances = std::move(fleet._instances);
+        this->_instanceBuffer = std::exchange(fleet._instanceBuffer, 0);
+        this->_moved = fleet._moved;
+    }
+    return *this;
 }
 
-void Forklift::setBox(std::unique_ptr<Box>& box)
+std::size_t ForkliftFleet::size() const
 {
-    if (box) {
-        this->_box = std::make_unique<Box>(*box);
-    } else {
-        this->_box = nullptr;  
-    }
+    return this->_instances.size();
 }
 
-void Forklift::setBox(std::unique_ptr<Box>&& box)
+unsigned int ForkliftFleet::player(std::size_t robot) const
 {
-    this->_box = std::move(box);
+    return this->_instances[robot].player;
 }
 
-void Forklift::translate(const glm::vec3& vector)
+const glm::mat4& ForkliftFleet::modelMatrix(std::size_t robot) const
 {
-    this->_modelMatrix = glm::translate(this->_modelMatrix, vector);
-    if (this->_box)
-        this->_box->translate(vector);
+    return this->_instances[robot].modelMatrix;
 }
 
-void Forklift::rotate(float angle, const glm::vec3& axis)
+void ForkliftFleet::setModelMatrix(std::size_t robot, const glm::mat4& modelMatrix)
 {
-    this->_modelMatrix = glm::rotate(this->_modelMatrix, angle, axis);
-    if (this->_box)
-        this->_box->rotate(angle, axis);
+    this->_instances[robot].modelMatrix = modelMatrix;
+    this->_moved = true;
 }
 
-void Forklift::draw(const Shader& shader, const Shader& boxShader) const
+void ForkliftFleet::draw(const Shader& shader)
 {
-    shader.use();
-    shader.setMat4("projection", this->_projectionMatrix);
-    shader.setMat4("view", this->_viewMatrix);
-    shader.setMat4("model", this->_modelMatrix);
-    for(const Mesh& mesh: this->_meshes)
-    {
-        shader.setVec3("material.ambient", mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
-        if (mesh.material()->name == "geel1")
-            shader.setVec3("material.diffuse", this->_color.x, this->_color.y, this->_color.z);
-        else
-            shader.setVec3("material.diffuse", mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
-        shader.setVec3("material.specular", mesh.material()->Kd.x, mesh.material()->Kd.y, mesh.material()->Kd.z);
-        shader.setFloat("material.shininess", mesh.material()->Ns);
-        shader.setVec3("light.ambient", 1.0, 1.0, 1.0);
-        shader.setVec3("light.diffuse", 1.0, 1.0, 1.0);
-        shader.setVec3("light.specular", 1.0, 1.0, 1.0);
-        mesh.draw();
-    }
-    if (this->_box)
-        this->_box->draw(boxShader);
+    if (this->_instances.empty())
+        return;
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, this->_instanceBuffer);
+    // most forklifts move every frame while playing, so the whole fleet goes up at once
+    if (this->_moved)
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, this->_instances.size() * sizeof(ForkliftInstance), this->_instances.data());
+    this->_moved = false;
+    glBindBufferBase(GL_SHADER_STORAGE_BUFFER, FORKLIFT_INSTANCE_BINDING, this->_instanceBuffer);
+    glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+    this->_forklift.draw(shader, static_cast<unsigned int>(this->_instances.size()));
 }
 
 Board::Board(
-    std::vector<Material>& materials, 
-    std::vector<Mesh>& meshes, 
-    std::string& directory,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
+    std::shared_ptr<const ModelAsset> asset,
     const glm::mat4& modelMatrix
 )
-: Model(materials, meshes, directory, projectionMatrix, viewMatrix, modelMatrix)
+: Model(std::move(asset), modelMatrix)
 {
 }
 
 Board::Board(
     const std::string& path,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
     const glm::mat4& modelMatrix
 )
-: Model(path, projectionMatrix, viewMatrix, modelMatrix)
+: Model(path, modelMatrix)
 {
 }
 
 void Board::draw(const Shader& shader) const
 {
     shader.use();
-    shader.setMat4("projection", this->_projectionMatrix);
-    shader.setMat4("view", this->_viewMatrix);
-    shader.setMat4("model", this->_modelMatrix);
-    for(const Mesh& mesh: this->_meshes)
+    shader.setMat4(UNIFORM_MODEL, this->_modelMatrix);
+    for(const Mesh& mesh: this->_asset->meshes)
     {   
-        for(unsigned int i = 0; i < mesh.material()->diffuseTextures.size(); ++i)
+        for(unsigned int i = 0; i < mesh.material()->diffuseTextures.size() && i < std::size(UNIFORM_TEXTURE_DIFFUSE); ++i)
         {
             // active proper texture unit before binding
             glActiveTexture(GL_TEXTURE0 + i); 
             // now set the sampler to the correct texture unit
-            shader.setInt("texture_diffuse"+std::to_string(i+1), i);
+            shader.setInt(UNIFORM_TEXTURE_DIFFUSE[i], i);
             // and finally bind the texture
             glBindTexture(GL_TEXTURE_2D, mesh.material()->diffuseTextures[i]);
         };
@@ -561,45 +418,86 @@ void Board::draw(const Shader& shader) const
 }
 
 Box::Box(
-    std::vector<Material>& materials, 
-    std::vector<Mesh>& meshes, 
-    std::string& directory,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
+    std::shared_ptr<const ModelAsset> asset,
     const glm::mat4& modelMatrix
 )
-: Model(materials, meshes, directory, projectionMatrix, viewMatrix, modelMatrix)
+: Model(std::move(asset), modelMatrix)
 {
 }
 
 Box::Box(
     const std::string& path,
-    const glm::mat4& projectionMatrix,
-    const glm::mat4& viewMatrix,
     const glm::mat4& modelMatrix
 )
-: Model(path, projectionMatrix, viewMatrix, modelMatrix)
+: Model(path, modelMatrix)
 {
 }
 
 void Box::draw(const Shader& shader) const
+{
+    this->draw(shader, this->_modelMatrix);
+}
+
+void Box::draw(const Shader& shader, const glm::mat4& modelMatrix) const
 {
     shader.use();
-    shader.setMat4("projection", this->_projectionMatrix);
-    shader.setMat4("view", this->_viewMatrix);
-    shader.setMat4("model", this->_modelMatrix);
-    for(const Mesh& mesh: this->_meshes)
+    shader.setMat4(UNIFORM_MODEL, modelMatrix);
+    for(const Mesh& mesh: this->_asset->meshes)
     {   
-        for(unsigned int i = 0; i < mesh.material()->diffuseTextures.size(); ++i)
+        for(unsigned int i = 0; i < mesh.material()->diffuseTextures.size() && i < std::size(UNIFORM_TEXTURE_DIFFUSE); ++i)
         {
             // active proper texture unit before binding
             glActiveTexture(GL_TEXTURE0 + i); 
             // now set the sampler to the correct texture unit
-            shader.setInt("texture_diffuse"+std::to_string(i+1), i);
+            shader.setInt(UNIFORM_TEXTURE_DIFFUSE[i], i);
             // and finally bind the texture
             glBindTexture(GL_TEXTURE_2D, mesh.material()->diffuseTextures[i]);
         };
         mesh.draw();
         glActiveTexture(GL_TEXTURE0);
     }
-}
\ No newline at end of file
+}
+BoxPool::BoxPool(
+    const std::string& path,
+    std::size_t size
+)
+: _box{path, glm::mat4(1.0f)}
+, _modelMatrices(size, glm::mat4(1.0f))
+, _spawned(size, false)
+{
+}
+
+std::size_t BoxPool::size() const
+{
+    return this->_spawned.size();
+}
+
+bool BoxPool::spawned(std::size_t slot) const
+{
+    return this->_spawned[slot];
+}
+
+void BoxPool::spawn(std::size_t slot, const glm::mat4& modelMatrix)
+{
+    this->_modelMatrices[slot] = modelMatrix;
+    this->_spawned[slot] = true;
+}
+
+void BoxPool::despawn(std::size_t slot)
+{
+    this->_spawned[slot] = false;
+}
+
+void BoxPool::setModelMatrix(std::size_t slot, const glm::mat4& modelMatrix)
+{
+    this->_modelMatrices[slot] = modelMatrix;
+}
+
+void BoxPool::draw(const Shader& shader) const
+{
+    for (std::size_t slot=0; slot<this->_spawned.size(); ++slot)
+    {
+        if (this->_spawned[slot])
+            this->_box.draw(shader, this->_modelMatrices[slot]);
+    }
+}
@@ -1,42 +1,15 @@
 #ifndef MODEL_H
 #define MODEL_H
-#define MAX_BONE_INFLUENCE 4
 #include <string>
 #include <vector>
 #include <memory>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
 #include <glad/glad.h> 
-#include <assimp/scene.h>
 
 #include "shader.hpp"
-
-enum class Orientation
-{
-    UP,
-    DOWN,
-    LEFT,
-    RIGHT,
-};
-
-std::ostream& operator<<(std::ostream& os, Orientation o);
-
-struct Vertex {
-    // position
-    glm::vec3 position;
-    // normal
-    glm::vec3 normal;
-    // texCoords
-    glm::vec2 texCoords;
-    // tangent
-    glm::vec3 tangent;
-    // bitangent
-    glm::vec3 bitangent;
-	//bone indexes which will influence this vertex
-	int boneIDs[MAX_BONE_INFLUENCE];
-	//weights from each bone
-	float boneWeights[MAX_BONE_INFLUENCE];
-};
+#include "texture.hpp"
+#include "modeldata.hpp"
 
 struct Material
 {   
@@ -49,124 +22,141 @@ struct Material
     glm::vec3 Kd;
     // Specular reflectivity
     glm::vec3 Ks;
-    // IDs of diffuse textures
+    // IDs of diffuse textures, held in the texture registry
     std::vector<unsigned int> diffuseTextures;
 };
 
 class Mesh 
 {
 public:
-    // mesh data
-    std::vector<Vertex>       vertices;
-    std::vector<unsigned int> indices;
-    // constructors
-    Mesh(std::vector<Vertex>& vertices, std::vector<unsigned int>& indices, Material* material);
-    Mesh(std::vector<Vertex>&& vertices, std::vector<unsigned int>&& indices, Material* material);
+    // upload vertices and indices, nothing is kept on the CPU
+    Mesh(const MeshView& view, Material* material);
+    // deletes the vertex array and buffers, the GL context must still be current
+    ~Mesh();
+    Mesh(const Mesh&) = delete;
+    Mesh& operator=(const Mesh&) = delete;
+    Mesh(Mesh&& mesh) noexcept;
+    Mesh& operator=(Mesh&& mesh) noexcept;
     Material* material() const;
     // render the mesh
     void draw() const;
+    // render count instances of the mesh, the shader tells them apart by gl_InstanceID
+    void drawInstanced(unsigned int count) const;
 private:
-    // render data 
-    unsigned int VAO, VBO, EBO;
-    Material* _material;
+    // render data, 0 once moved from
+    unsigned int VAO{0}, VBO{0}, EBO{0};
+    unsigned int _numIndices{0};
+    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+    GLenum _indexType{GL_UNSIGNED_INT};
+    Material* _material{nullptr};
+
+    void _deleteBuffers();
+};
+
+// everything loaded from one model file, shared by every Model drawn from it
+struct ModelAsset
+{
+    ModelAsset() = default;
+    // meshes point into materials, an asset is never copied or moved once loaded
+    ModelAsset(const ModelAsset&) = delete;
+    ModelAsset& operator=(const ModelAsset&) = delete;
+    // releases the textures of the materials, the meshes delete their own buffers
+    ~ModelAsset();
+    std::vector<Material> materials;
+    std::vector<Mesh> meshes;
+    std::string directory;
 };
 
+// import path unless a live model already uses it, in which case its asset is shared.
+// meshes come from the baked copy next to the file when it is up to date, assimp only runs to bake it
+std::shared_ptr<const ModelAsset> loadModelAsset(const std::string& path);
+// loadModelAsset for every path, importing and decoding textures on all cores at once.
+// only the uploads run on the calling thread, which must own the GL context
+std::vector<std::shared_ptr<const ModelAsset>> loadModelAssets(const std::vector<std::string>& paths);
+
 class Model 
 {
 public:
     Model() = default;
     Model(
-        std::vector<Material>& materials, 
-        std::vector<Mesh>& meshes, 
-        std::string& directory,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
+        std::shared_ptr<const ModelAsset> asset,
         const glm::mat4& modelMatrix
     );
-    // constructor, expects a filepath to a 3D model.
+    // constructor, expects a filepath to a 3D model. the file is only imported by the first model using it
     Model(
         const std::string& path,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
         const glm::mat4& modelMatrix
     );
     virtual ~Model() = default;
-    const glm::mat4& projectionMatrix() const;
-    void setProjectionMatrix(const glm::mat4& projectionTransform);
-    const glm::mat4& viewMatrix() const;
-    void setViewMatrix(const glm::mat4& viewTransform);
     const glm::mat4& modelMatrix() const;
     void setModelMatrix(const glm::mat4& modelTransform);
-    virtual void translate(const glm::vec3& vector);
-    virtual void rotate(float angle, const glm::vec3& axis);
 
 protected:
-    std::vector<Material> _materials;
-    std::vector<Mesh> _meshes;
-    std::string _directory;
-    glm::mat4 _projectionMatrix;
-    glm::mat4 _viewMatrix;
+    std::shared_ptr<const ModelAsset> _asset;
+    // projection and view come from the Camera block
     glm::mat4 _modelMatrix;
-
-    void _loadModel(const std::string& path);
-    std::vector<Material> _setupMaterials(const aiScene* aiscene);
-    std::vector<unsigned int> _setupTextures(aiMaterial *mat, aiTextureType type);
 };
 
-unsigned int textureFromFile(const char *path, const std::string &directory);
-std::vector<Vertex> setupVertices(aiMesh* mesh);
-std::vector<unsigned int> setupIndices(aiMesh* mesh);
-
-class Box;
-
 class Forklift: public Model
 {
 public:
     Forklift() = default;
     Forklift(
-        std::vector<Material>& materials, 
-        std::vector<Mesh>& meshes, 
-        std::string& directory,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
-        const glm::mat4& modelMatrix,
-        unsigned int x,
-        unsigned int y,
-        glm::vec3 color
+        std::shared_ptr<const ModelAsset> asset,
+        const glm::mat4& modelMatrix
     );
     // constructor, expects a filepath to a 3D model.
     Forklift(
         const std::string& path,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
-        const glm::mat4& modelMatrix,
-        unsigned int x,
-        unsigned int y,
-        glm::vec3 color
+        const glm::mat4& modelMatrix
     );
-    // copy constructor
-    Forklift(const Forklift& forklift);
-    // copy assignment
-    Forklift& operator=(const Forklift& forklift);
-    void draw(const Shader& shader, const Shader& boxShader) const;
-    void translate(const glm::vec3& vector) override;
-    void rotate(float angle, const glm::vec3& axis) override;
-    unsigned int x() const;
-    void setX(unsigned int x);
-    unsigned int y() const;
-    void setY(unsigned int y);
-    Orientation orientation() const;
-    const glm::vec3& color() const;
-    void setOrientation(Orientation orient);
-    const std::unique_ptr<Box>& box() const;
-    void setBox(std::unique_ptr<Box>& box); 
-    void setBox(std::unique_ptr<Box>&& box);
+    // draw count forklifts, placed and colored by the instances bound at FORKLIFT_INSTANCE_BINDING
+    void draw(const Shader& shader, unsigned int count) const;
+};
+
+// shader storage binding of the forklift instances notexture.vs reads
+inline constexpr unsigned int FORKLIFT_INSTANCE_BINDING{1};
+
+// one forklift as notexture.vs reads it, std430 layout
+struct ForkliftInstance
+{
+    glm::mat4 modelMatrix;
+    // index into the palette the yellow parts are colored from
+    unsigned int player;
+    unsigned int padding[3];
+};
+
+static_assert(sizeof(ForkliftInstance) == 80);
+
+// every forklift of a game drawn from one Forklift, one instanced draw per mesh however many there are
+class ForkliftFleet
+{
+public:
+    ForkliftFleet() = default;
+    // one forklift per entry of players, all at the origin
+    ForkliftFleet(
+        const std::string& path,
+        const std::vector<unsigned int>& players
+    );
+    // deletes the instance buffer, which only ever has one owner
+    ~ForkliftFleet();
+    ForkliftFleet(const ForkliftFleet&) = delete;
+    ForkliftFleet& operator=(const ForkliftFleet&) = delete;
+    ForkliftFleet(ForkliftFleet&& fleet) noexcept;
+    ForkliftFleet& operator=(ForkliftFleet&& fleet) noexcept;
+    std::size_t size() const;
+    unsigned int player(std::size_t robot) const;
+    const glm::mat4& modelMatrix(std::size_t robot) const;
+    void setModelMatrix(std::size_t robot, const glm::mat4& modelMatrix);
+    // upload the instances if any moved, then draw every forklift
+    void draw(const Shader& shader);
 private:
-    unsigned int _x;
-    unsigned int _y;
-    glm::vec3 _color;
-    Orientation _orient{Orientation::DOWN};
-    std::unique_ptr<Box> _box{nullptr};
+    Forklift _forklift;
+    // indexed by robot
+    std::vector<ForkliftInstance> _instances;
+    // shader storage buffer holding _instances
+    unsigned int _instanceBuffer{0};
+    bool _moved{false};
 };
 
 class Board: public Model
@@ -174,18 +164,12 @@ class Board: public Model
 public:
     Board() = default;
     Board(        
-        std::vector<Material>& materials, 
-        std::vector<Mesh>& meshes, 
-        std::string& directory,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
+        std::shared_ptr<const ModelAsset> asset,
         const glm::mat4& modelMatrix
     );
     // constructors, expects a filepath to a 3D model.
     Board(
         const std::string& path,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
         const glm::mat4& modelMatrix
     );
     void draw(const Shader& shader) const;
@@ -196,21 +180,41 @@ class Box: public Model
 public:
     Box() = default;
     Box(
-        std::vector<Material>& materials, 
-        std::vector<Mesh>& meshes, 
-        std::string& directory,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
+        std::shared_ptr<const ModelAsset> asset,
         const glm::mat4& modelMatrix
     );
     // constructor, expects a filepath to a 3D model.
     Box(
         const std::string& path,
-        const glm::mat4& projectionMatrix,
-        const glm::mat4& viewMatrix,
         const glm::mat4& modelMatrix
     );
     void draw(const Shader& shader) const;
+    // draw at modelMatrix instead of the box's own
+    void draw(const Shader& shader, const glm::mat4& modelMatrix) const;
+};
+
+// every box of a game drawn from one Box. a box appearing, vanishing or changing hands only turns
+// slots on and off, nothing is loaded or freed while playing
+class BoxPool
+{
+public:
+    BoxPool() = default;
+    BoxPool(
+        const std::string& path,
+        std::size_t size
+    );
+    std::size_t size() const;
+    bool spawned(std::size_t slot) const;
+    void spawn(std::size_t slot, const glm::mat4& modelMatrix);
+    void despawn(std::size_t slot);
+    void setModelMatrix(std::size_t slot, const glm::mat4& modelMatrix);
+    // draw every spawned box
+    void draw(const Shader& shader) const;
+private:
+    Box _box;
+    // indexed by slot
+    std::vector<glm::mat4> _modelMatrices;
+    std::vector<bool> _spawned;
 };
 
 #endif
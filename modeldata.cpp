@@ -0,0 +1,254 @@
+#include <string>
+#include <iostream>
+#include <vector>
+#include <cstring>
+#include <optional>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include <assimp/Importer.hpp>
+#include <assimp/scene.h>
+#include <assimp/postprocess.h>
+
+#include "modeldata.hpp"
+#include "meshopt.hpp"
+
+std::size_t vertexStride(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::POSITION:
+            return 3*sizeof(float);
+        case VertexFormat::POSITION_TEXCOORDS:
+            return 5*sizeof(float);
+        case VertexFormat::HALF_POSITION:
+            return 4*sizeof(std::uint16_t);
+        case VertexFormat::HALF_POSITION_TEXCOORDS:
+            return 6*sizeof(std::uint16_t);
+    }
+    return 0;
+}
+
+std::size_t texCoordsOffset(VertexFormat format)
+{
+    switch (format)
+    {
+        case VertexFormat::POSITION_TEXCOORDS:
+            return vertexStride(VertexFormat::POSITION);
+        case VertexFormat::HALF_POSITION_TEXCOORDS:
+            return vertexStride(VertexFormat::HALF_POSITION);
+        default:
+            return 0;
+    }
+}
+
+bool halfFloats(VertexFormat format)
+{
+    return format == VertexFormat::HALF_POSITION || format == VertexFormat::HALF_POSITION_TEXCOORDS;
+}
+
+VertexFormat vertexFormat(const MaterialData& material)
+{
+    if (material.diffuseTextures.empty())
+        return HALF_VERTEX_FORMATS ? VertexFormat::HALF_POSITION : VertexFormat::POSITION;
+    return HALF_VERTEX_FORMATS ? VertexFormat::HALF_POSITION_TEXCOORDS : VertexFormat::POSITION_TEXCOORDS;
+}
+
+glm::vec3 vertexPosition(const char* vertex, VertexFormat format)
+{
+    if (halfFloats(format))
+    {
+        std::uint16_t packed[3];
+        std::memcpy(packed, vertex, sizeof(packed));
+        return glm::vec3(glm::unpackHalf1x16(packed[0]), glm::unpackHalf1x16(packed[1]), glm::unpackHalf1x16(packed[2]));
+    }
+    float packed[3];
+    std::memcpy(packed, vertex, sizeof(packed));
+    return glm::vec3(packed[0], packed[1], packed[2]);
+}
+
+std::size_t indexSize(std::size_t numVertices)
+{
+    return numVertices <= 65536 ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+}
+
+std::vector<char> packIndices(const std::vector<unsigned int>& indices, std::size_t numVertices)
+{
+    std::vector<char> packed(indices.size()*indexSize(numVertices));
+    if (indexSize(numVertices) == sizeof(std::uint32_t))
+    {
+        std::memcpy(packed.data(), indices.data(), packed.size());
+        return packed;
+    }
+    for (std::size_t i=0; i<indices.size(); ++i)
+    {
+        std::uint16_t index{static_cast<std::uint16_t>(indices[i])};
+        std::memcpy(&packed[i*sizeof(index)], &index, sizeof(index));
+    }
+    return packed;
+}
+
+std::vector<unsigned int> unpackIndices(const char* indices, std::size_t numIndices, std::size_t numVertices)
+{
+    std::vector<unsigned int> unpacked(numIndices);
+    if (indexSize(numVertices) == sizeof(std::uint32_t))
+    {
+        std::memcpy(unpacked.data(), indices, numIndices*sizeof(std::uint32_t));
+        return unpacked;
+    }
+    for (std::size_t i=0; i<numIndices; ++i)
+    {
+        std::uint16_t index;
+        std::memcpy(&index, indices + i*sizeof(index), sizeof(index));
+        unpacked[i] = index;
+    }
+    return unpacked;
+}
+
+std::size_t MeshData::numVertices() const
+{
+    return this->vertices.size()/vertexStride(this->format);
+}
+
+std::size_t MeshData::numIndices() const
+{
+    return this->indices.size()/indexSize(this->numVertices());
+}
+
+MeshView MeshData::view() const
+{
+    return MeshView{this->material, this->format, this->vertices.data(), this->numVertices(), this->indices.data(), this->numIndices()};
+}
+
+std::optional<ModelData> importModel(const std::string& path)
+{
+    // read file via ASSIMP. the shaders only read positions and texture coordinates, so no normals or tangents
+    Assimp::Importer importer;
+    const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+    // check for errors
+    if(!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode)
+    {
+        std::cout << "ERROR::ASSIMP:: " << importer.GetErrorString() << std::endl;
+        return std::nullopt;
+    };
+    ModelData data;
+    data.materials = setupMaterials(scene);
+    data.meshes.reserve(scene->mNumMeshes);
+    for(unsigned int i = 0; i < scene->mNumMeshes; i++)
+    {   
+        aiMesh* mesh{scene->mMeshes[i]};
+        VertexFormat format{vertexFormat(data.materials[mesh->mMaterialIndex])};
+        data.meshes.push_back(MeshData{mesh->mMaterialIndex, format, setupVertices(mesh, format), packIndices(setupIndices(mesh), mesh->mNumVertices)});
+    };
+    return data;
+}
+
+void optimizeMesh(MeshData& mesh)
+{
+    std::size_t stride{vertexStride(mesh.format)};
+    std::vector<unsigned int> indices{unpackIndices(mesh.indices.data(), mesh.numIndices(), mesh.numVertices())};
+    weldVertices(mesh.vertices, stride, indices);
+    optimizeVertexCache(indices, mesh.vertices.size()/stride);
+    std::vector<glm::vec3> positions(mesh.vertices.size()/stride);
+    for (std::size_t vertex=0; vertex<positions.size(); ++vertex)
+        positions[vertex] = vertexPosition(&mesh.vertices[vertex*stride], mesh.format);
+    optimizeOverdraw(indices, positions);
+    optimizeVertexFetch(mesh.vertices, stride, indices);
+    mesh.indices = packIndices(indices, mesh.vertices.size()/stride);
+}
+
+std::vector<MaterialData> setupMaterials(const aiScene* aiscene)
+{   
+    // data to fill
+    std::vector<MaterialData> materials(aiscene->mNumMaterials);
+    for (unsigned int i=0; i<aiscene->mNumMaterials; ++i)
+    {
+        MaterialData* material{&materials[i]};
+        aiMaterial* aiMaterial{aiscene->mMaterials[i]};
+        aiColor3D ambient;
+        aiColor3D diffuse;
+        aiColor3D specular;
+        float shininess;
+        material->name = aiMaterial->GetName().C_Str();
+        // Ambient color
+        if (aiMaterial->Get(AI_MATKEY_COLOR_AMBIENT, ambient) == AI_SUCCESS) {
+            material->Ka.x=ambient.r;
+            material->Ka.y=ambient.b;
+            material->Ka.z=ambient.g;
+        };
+        // Diffuse color
+        if (aiMaterial->Get(AI_MATKEY_COLOR_DIFFUSE, diffuse) == AI_SUCCESS) {
+            material->Kd.x=diffuse.r;
+            material->Kd.y=diffuse.b;
+            material->Kd.z=diffuse.g;
+        };
+        // Specular color
+        if (aiMaterial->Get(AI_MATKEY_COLOR_SPECULAR, specular) == AI_SUCCESS) {
+            material->Ks.x=specular.r;
+            material->Ks.y=specular.b;
+            material->Ks.z=specular.g;
+        };
+        // Shininess (Specular exponent)
+        if (aiMaterial->Get(AI_MATKEY_SHININESS, shininess) == AI_SUCCESS) {
+            material->Ns=shininess;
+        };
+        // Diffuse textures
+        material->diffuseTextures=setupTextures(aiMaterial, aiTextureType_DIFFUSE);
+    };
+    return materials;
+};
+
+std::vector<std::string> setupTextures(aiMaterial *mat, aiTextureType type)
+{
+    std::vector<std::string> textures;
+    for(unsigned int i = 0; i < mat->GetTextureCount(type); i++)
+    {
+        aiString str;
+        mat->GetTexture(type, i, &str);
+        textures.push_back(str.C_Str());
+    };
+    return textures;
+};
+
+std::vector<char> setupVertices(aiMesh* mesh, VertexFormat format)
+{
+    // data to fill
+    std::size_t stride{vertexStride(format)};
+    std::vector<char> vertices(mesh->mNumVertices*stride);
+    // a vertex can contain up to 8 different texture coordinates. We thus make the assumption that we won't 
+    // use models where a vertex can have multiple texture coordinates so we always take the first set (0).
+    aiVector3D* aiTextureCoords_0{mesh->mTextureCoords[0]};
+    // walk through each of the mesh's vertices
+    for(unsigned int i = 0; i < mesh->mNumVertices; i++)
+    {
+        char* vertex{&vertices[i*stride]};
+        aiVector3D position{mesh->mVertices[i]};
+        // meshes without texture coordinates sample the corner of the texture
+        aiVector3D texCoords{aiTextureCoords_0 ? aiTextureCoords_0[i] : aiVector3D()};
+        if (halfFloats(format))
+        {
+            std::uint16_t packed[6]{
+                glm::packHalf1x16(position.x), glm::packHalf1x16(position.y), glm::packHalf1x16(position.z), 0,
+                glm::packHalf1x16(texCoords.x), glm::packHalf1x16(texCoords.y)
+            };
+            std::memcpy(vertex, packed, stride);
+        }
+        else
+        {
+            float packed[5]{position.x, position.y, position.z, texCoords.x, texCoords.y};
+            std::memcpy(vertex, packed, stride);
+        }
+    };
+    return vertices;
+};
+
+std::vector<unsigned int> setupIndices(aiMesh* mesh)
+{
+    std::vector<unsigned int> indices;
+    for(unsigned int i = 0; i < mesh->mNumFaces; ++i)
+    {
+        aiFace* face = mesh->mFaces;
+        for(unsigned int j = 0; j < face[i].mNumIndices; ++j)
+            indices.push_back(face[i].mIndices[j]);        
+    };
+    return indices;
+};
@@ -0,0 +1,108 @@
+#ifndef MODELDATA_H
+#define MODELDATA_H
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include <assimp/scene.h>
+
+// models as plain data on the CPU: imported, optimized and packed the way they are uploaded.
+// nothing here touches GL, so it runs on loader threads and in tools
+
+// vertex positions and texture coordinates as half floats, build with -DHALF_VERTICES
+#ifdef HALF_VERTICES
+inline constexpr bool HALF_VERTEX_FORMATS{true};
+#else
+inline constexpr bool HALF_VERTEX_FORMATS{false};
+#endif
+
+// what a mesh's vertex buffer holds, only the attributes the shader drawing it reads
+enum class VertexFormat : std::uint8_t
+{
+    // 3 floats at location 0, for notexture, 12 bytes
+    POSITION,
+    // and 2 floats at location 2, for withtexture, 20 bytes
+    POSITION_TEXCOORDS,
+    // 3 half floats padded to 4, 8 bytes
+    HALF_POSITION,
+    // and 2 half floats, 12 bytes
+    HALF_POSITION_TEXCOORDS,
+};
+
+// bytes per vertex
+std::size_t vertexStride(VertexFormat format);
+// byte offset of the texture coordinates in a vertex, 0 if the format has none
+std::size_t texCoordsOffset(VertexFormat format);
+bool halfFloats(VertexFormat format);
+
+// position of a vertex packed in format
+glm::vec3 vertexPosition(const char* vertex, VertexFormat format);
+
+// bytes per index, GL_UNSIGNED_SHORT indices when every vertex fits in them
+std::size_t indexSize(std::size_t numVertices);
+std::vector<char> packIndices(const std::vector<unsigned int>& indices, std::size_t numVertices);
+std::vector<unsigned int> unpackIndices(const char* indices, std::size_t numIndices, std::size_t numVertices);
+
+// a material as read from the model file, before its textures are loaded
+struct MaterialData
+{
+    std::string name;
+    float Ns;
+    glm::vec3 Ka;
+    glm::vec3 Kd;
+    glm::vec3 Ks;
+    // diffuse texture paths, relative to the model directory
+    std::vector<std::string> diffuseTextures;
+};
+
+// textured materials are drawn by withtexture and need texture coordinates, the rest only positions
+VertexFormat vertexFormat(const MaterialData& material);
+
+// vertices and indices ready to upload, pointing into a MeshData or a baked model file
+struct MeshView
+{
+    // index into the model's materials
+    unsigned int material;
+    VertexFormat format;
+    // numVertices*vertexStride(format) bytes
+    const char* vertices;
+    std::size_t numVertices;
+    // numIndices*indexSize(numVertices) bytes
+    const char* indices;
+    std::size_t numIndices;
+};
+
+struct MeshData
+{
+    unsigned int material;
+    VertexFormat format;
+    // packed in format
+    std::vector<char> vertices;
+    // packed with packIndices
+    std::vector<char> indices;
+    std::size_t numVertices() const;
+    std::size_t numIndices() const;
+    MeshView view() const;
+};
+
+// a model file imported into plain data, nothing uploaded yet
+struct ModelData
+{
+    std::vector<MaterialData> materials;
+    std::vector<MeshData> meshes;
+};
+
+// run assimp over path, nothing if it fails to import
+std::optional<ModelData> importModel(const std::string& path);
+// weld identical vertices, then order triangles for the vertex cache and overdraw and vertices for fetching
+void optimizeMesh(MeshData& mesh);
+
+std::vector<MaterialData> setupMaterials(const aiScene* aiscene);
+std::vector<std::string> setupTextures(aiMaterial *mat, aiTextureType type);
+// vertices of mesh packed in format
+std::vector<char> setupVertices(aiMesh* mesh, VertexFormat format);
+std::vector<unsigned int> setupIndices(aiMesh* mesh);
+
+#endif
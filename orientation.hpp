@@ -0,0 +1,25 @@
+#ifndef ORIENTATION_H
+#define ORIENTATION_H
+#include <cstdint>
+#include <ostream>
+
+enum class Orientation : std::uint8_t
+{
+    UP,
+    DOWN,
+    LEFT,
+    RIGHT,
+};
+
+inline std::ostream& operator<<(std::ostream& os, Orientation o)
+{
+    switch (o) {
+        case Orientation::UP:   return os << "UP";
+        case Orientation::DOWN: return os << "DOWN";
+        case Orientation::LEFT:  return os << "LEFT";
+        case Orientation::RIGHT:  return os << "RIGHT";
+    }
+    return os << "Unknown";
+}
+
+#endif
@@ -0,0 +1,28 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// call f(i) for every i in [0, count), spread over one thread per core with the caller as one of them.
+// indices are handed out one at a time, so a few slow items don't hold up the rest
+template <typename F>
+void parallelFor(std::size_t count, F f)
+{
+    std::atomic<std::size_t> next{0};
+    auto work{[&]() {
+        for (std::size_t i{next++}; i < count; i = next++)
+            f(i);
+    }};
+    std::size_t numThreads{std::min<std::size_t>(count, std::max(1u, std::thread::hardware_concurrency()))};
+    std::vector<std::thread> threads;
+    for (std::size_t thread=1; thread<numThreads; ++thread)
+        threads.emplace_back(work);
+    work();
+    for (std::thread& thread : threads)
+        thread.join();
+}
+
+#endif
@@ -0,0 +1,195 @@
+#include <iostream>
+#include <chrono>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "parser.hpp"
+#include "mappedfile.hpp"
+#include "replay.hpp"
+#include "follower.hpp"
+
+ParserThread::ParserThread(const std::string& logFile, bool follow, unsigned int boardSize)
+: _boardSize{boardSize}
+{
+    // exiting from the parser thread would run static destructors under the model loaders
+    if (follow)
+        this->_follower = std::make_unique<LogFollower>(logFile);
+    else if (isReplayFile(logFile))
+        // a replay is a straight copy, nothing to gain from streaming it
+        this->_replay = loadReplay(logFile);
+    else
+    {
+        this->_log = std::make_unique<MappedFile>(logFile);
+        if (!this->_log->isOpen())
+        {
+            std::cerr << "Failed to open file.\n";
+            exit(1);
+        }
+    }
+    this->_thread = std::thread{&ParserThread::_parse, this};
+}
+
+ParserThread::~ParserThread()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->_queueMutex);
+        this->_stop.store(true, std::memory_order_relaxed);
+    }
+    this->_popped.notify_one();
+    this->_thread.join();
+}
+
+bool ParserThread::waitStarted(int timeoutMs) const
+{
+    std::unique_lock<std::mutex> lock(this->_startMutex);
+    return this->_startChanged.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+        return this->_started.load(std::memory_order_acquire);
+    });
+}
+
+const Episode& ParserThread::header() const
+{
+    return this->_header;
+}
+
+const SimulationState& ParserThread::startState() const
+{
+    return this->_startState;
+}
+
+bool ParserThread::pop(Event& event)
+{
+    if (!this->_events.pop(event))
+        return false;
+    // pairs with the fence in _push, either it sees the freed slot or we see it waiting
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (this->_producerWaiting.load(std::memory_order_relaxed))
+    {
+        std::lock_guard<std::mutex> lock(this->_queueMutex);
+        this->_producerWaiting.store(false, std::memory_order_relaxed);
+        this->_popped.notify_one();
+    }
+    return true;
+}
+
+void ParserThread::waitForEvents(int timeoutMs) const
+{
+    std::unique_lock<std::mutex> lock(this->_queueMutex);
+    // pushes don't signal, that would cost the parser a fence per event. a full ring or the end does
+    this->_pushed.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this]() {
+        return !this->_events.empty() || this->_finished.load(std::memory_order_acquire);
+    });
+}
+
+bool ParserThread::done() const
+{
+    return this->_finished.load(std::memory_order_acquire) && this->_events.empty();
+}
+
+void ParserThread::_parse()
+{
+    Episode episode;
+    if (this->_boardSize > 0)
+        episode.boardSize = this->_boardSize;
+    if (this->_follower)
+    {
+        LogFollower& follower{*this->_follower};
+        // the environment may not have written the header and start positions yet
+        while (!follower.started(episode) && !this->_stop.load(std::memory_order_relaxed))
+            follower.wait(episode, FOLLOW_TIMEOUT_MS);
+        // join live: events written before we started are applied, not animated
+        SimulationState state{episode};
+        for (const Event& event : episode.events)
+            state.apply(event);
+        episode.events.clear();
+        this->_start(episode, state);
+        while (!this->_stop.load(std::memory_order_relaxed))
+        {
+            follower.wait(episode, FOLLOW_TIMEOUT_MS);
+            for (const Event& event : episode.events)
+                if (!this->_push(event))
+                    break;
+            episode.events.clear();
+        }
+    }
+    else if (this->_log)
+    {
+        // logs don't state their board size and the header can't change once handed on, so every
+        // move and pickup is looked at first
+        if (this->_boardSize == 0)
+        {
+            Episode scan;
+            forEachLineWhile(this->_log->data(), [this, &scan](std::string_view line) {
+                parseLogLine(line, scan);
+                scan.events.clear();
+                return !this->_stop.load(std::memory_order_relaxed);
+            });
+            episode.boardSize = scan.boardSize;
+        }
+        // closing the window stops us at the next event instead of the end of the file
+        forEachLineWhile(this->_log->data(), [this, &episode](std::string_view line) {
+            if (parseLogLine(line, episode) != LineKind::EVENT)
+                return true;
+            // header and positions come first, so they are complete at the first event
+            if (!this->_started.load(std::memory_order_relaxed))
+                this->_start(episode, SimulationState{episode});
+            bool pushed{this->_push(episode.events.back())};
+            episode.events.clear();
+            return pushed;
+        });
+        if (!this->_started.load(std::memory_order_relaxed))
+            this->_start(episode, SimulationState{episode});
+    }
+    else
+    {
+        this->_start(this->_replay, SimulationState{this->_replay});
+        for (const Event& event : this->_replay.events)
+            if (!this->_push(event))
+                break;
+        // everything went through the ring, the render thread keeps its own copy
+        std::vector<Event>().swap(this->_replay.events);
+    }
+    {
+        std::lock_guard<std::mutex> lock(this->_queueMutex);
+        this->_finished.store(true, std::memory_order_release);
+    }
+    this->_pushed.notify_all();
+}
+
+void ParserThread::_start(const Episode& episode, const SimulationState& state)
+{
+    this->_header.numRobotsPerPlayer = episode.numRobotsPerPlayer;
+    this->_header.numPlayers = episode.numPlayers;
+    this->_header.players = episode.players;
+    this->_header.boardSize = episode.boardSize;
+    this->_header.initialPositions = episode.initialPositions;
+    this->_startState = state;
+    {
+        std::lock_guard<std::mutex> lock(this->_startMutex);
+        this->_started.store(true, std::memory_order_release);
+    }
+    this->_startChanged.notify_all();
+}
+
+bool ParserThread::_push(const Event& event)
+{
+    if (this->_stop.load(std::memory_order_relaxed))
+        return false;
+    while (!this->_events.push(event))
+    {
+        // the render thread is behind, sleep until it pops
+        this->_pushed.notify_all();
+        std::unique_lock<std::mutex> lock(this->_queueMutex);
+        this->_producerWaiting.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        this->_popped.wait(lock, [this]() {
+            return !this->_events.full() || this->_stop.load(std::memory_order_relaxed);
+        });
+        this->_producerWaiting.store(false, std::memory_order_relaxed);
+        if (this->_stop.load(std::memory_order_relaxed))
+            return false;
+    }
+    return true;
+}
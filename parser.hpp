@@ -0,0 +1,72 @@
+#ifndef PARSER_H
+#define PARSER_H
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "episode.hpp"
+#include "follower.hpp"
+#include "mappedfile.hpp"
+#include "simulation.hpp"
+#include "spscqueue.hpp"
+
+inline constexpr std::size_t EVENT_QUEUE_CAPACITY{1 << 16};
+// longest waitForEvents() sleeps on an empty ring before checking again
+inline constexpr int EVENT_WAIT_MS{1};
+
+// parses a log or replay on its own thread and hands events to the render thread as they are decoded
+class ParserThread
+{
+public:
+    // with follow, keep reading events appended to logFile until destroyed.
+    // exits if logFile can't be opened or is not a valid replay, before the thread starts.
+    // boardSize is the size a text log's board grows from. 0 infers all of it, which means reading
+    // the whole log before the header is handed on, or only what is written so far when following
+    ParserThread(const std::string& logFile, bool follow, unsigned int boardSize = 0);
+    ~ParserThread();
+    ParserThread(const ParserThread&) = delete;
+    ParserThread& operator=(const ParserThread&) = delete;
+    // block until the header and start positions are known or timeoutMs passes, false on timeout
+    bool waitStarted(int timeoutMs) const;
+    // header and start positions, events left empty. valid after waitStarted()
+    const Episode& header() const;
+    // state the first popped event applies to. valid after waitStarted()
+    const SimulationState& startState() const;
+    bool pop(Event& event);
+    // sleep until an event can be popped, the file is fully parsed or timeoutMs passes
+    void waitForEvents(int timeoutMs) const;
+    // true once the file is fully parsed and every event was popped
+    bool done() const;
+private:
+    // the source _parse reads, opened by the constructor. a replay is loaded whole when neither is set
+    std::unique_ptr<LogFollower> _follower{nullptr};
+    std::unique_ptr<MappedFile> _log{nullptr};
+    Episode _replay;
+    unsigned int _boardSize{0};
+    Episode _header;
+    SimulationState _startState;
+    SpscQueue<Event, EVENT_QUEUE_CAPACITY> _events;
+    std::atomic<bool> _started{false};
+    // signals _started
+    mutable std::mutex _startMutex;
+    mutable std::condition_variable _startChanged;
+    // the parser sleeps on _popped while the ring is full, the render thread on _pushed while it is empty
+    mutable std::mutex _queueMutex;
+    std::condition_variable _popped;
+    mutable std::condition_variable _pushed;
+    std::atomic<bool> _producerWaiting{false};
+    std::atomic<bool> _finished{false};
+    std::atomic<bool> _stop{false};
+    std::thread _thread;
+
+    void _parse();
+    void _start(const Episode& episode, const SimulationState& state);
+    // false once the parser is stopping, nothing more needs parsing then
+    bool _push(const Event& event);
+};
+
+#endif
@@ -0,0 +1,214 @@
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "replay.hpp"
+#include "mappedfile.hpp"
+
+namespace
+{
+
+// why loadReplay would reject episode once saved, empty if it wouldn't
+std::string replayError(const Episode& episode)
+{
+    // larger boards would wrap their cells
+    if (episode.boardSize > REPLAY_MAX_BOARD_SIZE)
+        return "boards larger than " + std::to_string(REPLAY_MAX_BOARD_SIZE) + " cells per side don't fit";
+    // so would a cell off the board, into another row
+    std::string board{" the " + std::to_string(episode.boardSize) + "x" + std::to_string(episode.boardSize) + " board"};
+    for (std::size_t robot=0; robot<episode.initialPositions.size(); ++robot)
+    {
+        const RobotPosition& position{episode.initialPositions[robot]};
+        if (position.player >= episode.numPlayers)
+            return "robot " + std::to_string(robot) + " belongs to a player beyond the " + std::to_string(episode.numPlayers) + " players";
+        if (position.x >= episode.boardSize || position.y >= episode.boardSize)
+            return "robot " + std::to_string(robot) + " starts off" + board;
+    }
+    for (const Event& event : episode.events)
+    {
+        // only spelled out for the event that fails
+        auto robot{[&event]() { return "t=" + std::to_string(event.tick) + " robot " + std::to_string(event.robot); }};
+        if (event.type == EventType::WIN)
+        {
+            if (event.robot >= episode.numPlayers)
+                return "t=" + std::to_string(event.tick) + " player " + std::to_string(event.robot) + " wins, beyond the " + std::to_string(episode.numPlayers) + " players";
+        }
+        else if (event.robot >= episode.initialPositions.size())
+            return robot() + " doesn't exist";
+        else if (event.type == EventType::MOVE && (event.x >= episode.boardSize || event.y >= episode.boardSize))
+            return robot() + " moves to (" + std::to_string(event.x) + "," + std::to_string(event.y) + "), off" + board;
+    }
+    return {};
+}
+
+}
+
+std::size_t replayLettersSize(unsigned int numPlayers)
+{
+    return (std::size_t{numPlayers} + 3)/4*4;
+}
+
+bool isReplayFile(const std::string& path)
+{
+    return path.size() >= 4 && path.compare(path.size() - 4, 4, ".rbr") == 0;
+}
+
+Episode loadReplay(const std::string& replayFile)
+{
+    MappedFile file(replayFile);
+    if (!file.isOpen())
+    {
+        std::cerr << "Failed to open file.\n";
+        exit(1);
+    }
+    std::string_view data{file.data()};
+    ReplayHeader header;
+    if (data.size() < sizeof(header))
+    {
+        std::cerr << "Invalid replay file.\n";
+        exit(1);
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    std::size_t numRobots = std::size_t{header.numRobotsPerPlayer}*header.numPlayers;
+    std::size_t lettersSize{header.version >= 3 ? replayLettersSize(header.numPlayers) : 0};
+    if (std::memcmp(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC)) != 0
+        || header.version == 0
+        || header.version > REPLAY_VERSION
+        || header.boardSize == 0
+        || header.boardSize > REPLAY_MAX_BOARD_SIZE
+        || data.size() != sizeof(header) + lettersSize + numRobots*sizeof(ReplayRobot) + std::size_t{header.numEvents}*sizeof(ReplayEvent))
+    {
+        std::cerr << "Invalid replay file.\n";
+        exit(1);
+    }
+    const char* letters{data.data() + sizeof(header)};
+    const char* robots{letters + lettersSize};
+    const char* events{robots + numRobots*sizeof(ReplayRobot)};
+    std::size_t numCells{std::size_t{header.boardSize}*header.boardSize};
+    // everything below indexes by robots, players and cells, a foreign file must not get that far
+    bool valid{true};
+
+    Episode episode;
+    episode.numRobotsPerPlayer = header.numRobotsPerPlayer;
+    episode.numPlayers = header.numPlayers;
+    episode.boardSize = header.boardSize;
+    if (lettersSize > 0)
+        episode.players.assign(letters, header.numPlayers);
+    episode.initialPositions.resize(numRobots);
+    for (std::size_t i=0; i<numRobots; ++i)
+    {
+        ReplayRobot robot;
+        std::memcpy(&robot, robots + i*sizeof(ReplayRobot), sizeof(robot));
+        if (robot.player >= header.numPlayers || robot.cell >= numCells)
+            valid = false;
+        episode.initialPositions[i] = RobotPosition{robot.player, robot.cell % header.boardSize, robot.cell / header.boardSize};
+    }
+    episode.events.resize(header.numEvents);
+    for (std::size_t i=0; i<header.numEvents; ++i)
+    {
+        ReplayEvent event;
+        std::memcpy(&event, events + i*sizeof(ReplayEvent), sizeof(event));
+        Event& decoded{episode.events[i]};
+        decoded = Event{event.tick, event.robot, EventType::MOVE, Orientation::DOWN, 0, 0, event.mail};
+        if (event.action > REPLAY_WIN
+            || event.robot >= (event.action == REPLAY_WIN ? header.numPlayers : numRobots)
+            || (event.action < REPLAY_PICKUP && event.cell >= numCells))
+        {
+            valid = false;
+            break;
+        }
+        switch (event.action)
+        {
+            case REPLAY_PICKUP:
+                decoded.type = EventType::PICKUP;
+                break;
+            case REPLAY_DROPOFF:
+                decoded.type = EventType::DROPOFF;
+                break;
+            case REPLAY_WIN:
+                decoded.type = EventType::WIN;
+                break;
+            default:
+                decoded.direction = static_cast<Orientation>(event.action);
+                decoded.x = static_cast<std::uint16_t>(event.cell % header.boardSize);
+                decoded.y = static_cast<std::uint16_t>(event.cell / header.boardSize);
+                break;
+        }
+    }
+    if (!valid)
+    {
+        std::cerr << "Invalid replay file.\n";
+        exit(1);
+    }
+    return episode;
+}
+
+void saveReplay(const Episode& episode, const std::string& replayFile)
+{
+    // checked before the file is opened, a rejected episode leaves no half written replay
+    std::string error{replayError(episode)};
+    if (!error.empty())
+    {
+        std::cerr << "Can't save replay: " << error << ".\n";
+        exit(1);
+    }
+    std::ofstream file(replayFile, std::ios::binary);
+    if (!file.is_open())
+    {
+        std::cerr << "Failed to open file.\n";
+        exit(1);
+    }
+    ReplayHeader header;
+    std::memcpy(header.magic, REPLAY_MAGIC, sizeof(REPLAY_MAGIC));
+    header.version = REPLAY_VERSION;
+    header.numRobotsPerPlayer = episode.numRobotsPerPlayer;
+    header.numPlayers = episode.numPlayers;
+    header.boardSize = episode.boardSize;
+    header.numEvents = static_cast<std::uint32_t>(episode.events.size());
+    // letters of players that never showed up in the log are left as spaces
+    std::string letters(replayLettersSize(episode.numPlayers), ' ');
+    std::size_t numLetters{std::min<std::size_t>(episode.players.size(), episode.numPlayers)};
+    letters.replace(0, numLetters, episode.players, 0, numLetters);
+    std::vector<ReplayRobot> robots;
+    robots.reserve(episode.initialPositions.size());
+    for (const RobotPosition& position : episode.initialPositions)
+        robots.push_back(ReplayRobot{
+            static_cast<std::uint16_t>(position.player),
+            static_cast<std::uint16_t>(position.y*episode.boardSize + position.x)
+        });
+    std::vector<ReplayEvent> events;
+    events.reserve(episode.events.size());
+    for (const Event& event : episode.events)
+    {
+        std::uint8_t action{static_cast<std::uint8_t>(event.direction)};
+        switch (event.type)
+        {
+            case EventType::MOVE:
+                break;
+            case EventType::PICKUP:
+                action = REPLAY_PICKUP;
+                break;
+            case EventType::DROPOFF:
+                action = REPLAY_DROPOFF;
+                break;
+            case EventType::WIN:
+                action = REPLAY_WIN;
+                break;
+        }
+        events.push_back(ReplayEvent{
+            event.tick,
+            event.robot,
+            static_cast<std::uint16_t>(event.y*episode.boardSize + event.x),
+            action,
+            0,
+            event.mail
+        });
+    }
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(letters.data(), letters.size());
+    file.write(reinterpret_cast<const char*>(robots.data()), robots.size()*sizeof(ReplayRobot));
+    file.write(reinterpret_cast<const char*>(events.data()), events.size()*sizeof(ReplayEvent));
+}
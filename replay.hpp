@@ -0,0 +1,64 @@
+#ifndef REPLAY_H
+#define REPLAY_H
+#include <cstdint>
+#include <string>
+
+#include "episode.hpp"
+
+// .rbr replay layout: ReplayHeader, then the player letters padded to a multiple of 4 bytes,
+// then one ReplayRobot per robot, then numEvents ReplayEvents.
+// fields are written in host byte order, which is little endian on every machine we run on.
+inline constexpr char REPLAY_MAGIC[4]{'R', 'B', 'R', '1'};
+// version 1 files only hold moves and read back unchanged, files before version 3 have no player letters
+inline constexpr std::uint32_t REPLAY_VERSION{3};
+// largest board whose cells fit the 16 bit cell fields
+inline constexpr unsigned int REPLAY_MAX_BOARD_SIZE{255};
+
+struct ReplayHeader
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t numRobotsPerPlayer;
+    std::uint32_t numPlayers;
+    std::uint32_t boardSize;
+    std::uint32_t numEvents;
+};
+
+struct ReplayRobot
+{
+    std::uint16_t player;
+    // y*boardSize + x
+    std::uint16_t cell;
+};
+
+// ReplayEvent::action values, moves store their Orientation (0 to 3)
+inline constexpr std::uint8_t REPLAY_PICKUP{4};
+inline constexpr std::uint8_t REPLAY_DROPOFF{5};
+inline constexpr std::uint8_t REPLAY_WIN{6};
+
+struct ReplayEvent
+{
+    std::uint32_t tick;
+    // player index for a win
+    std::uint16_t robot;
+    // move target cell, y*boardSize + x
+    std::uint16_t cell;
+    std::uint8_t action;
+    std::uint8_t reserved;
+    std::uint16_t mail;
+};
+
+static_assert(sizeof(ReplayHeader) == 24);
+static_assert(sizeof(ReplayRobot) == 4);
+static_assert(sizeof(ReplayEvent) == 12);
+
+// bytes taken by the player letters
+std::size_t replayLettersSize(unsigned int numPlayers);
+bool isReplayFile(const std::string& path);
+// exits on files that are cut short or refer to robots, players or cells that don't exist
+Episode loadReplay(const std::string& replayFile);
+// exits on everything loadReplay would reject: boards larger than REPLAY_MAX_BOARD_SIZE and robots,
+// players or cells that don't exist
+void saveReplay(const Episode& episode, const std::string& replayFile);
+
+#endif
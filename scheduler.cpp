@@ -0,0 +1,159 @@
+#include <algorithm>
+
+#include "scheduler.hpp"
+
+int actionSlot(const Action& action)
+{
+    switch (action.type)
+    {
+        case EventType::MOVE:
+            return action.from.emptiedSlot;
+        case EventType::PICKUP:
+            return action.to.emptiedSlot;
+        default:
+            return NO_SLOT;
+    }
+}
+
+ActionScheduler::ActionScheduler(unsigned int numRobots, unsigned int boardSize)
+: _boardSize{boardSize}
+, _actions(numRobots)
+, _busyCells(boardSize*boardSize, 0)
+, _departures(boardSize*boardSize, 0.0)
+, _busySlots(numPickupCells(boardSize), false)
+{
+}
+
+double ActionScheduler::clock() const
+{
+    return this->_clock;
+}
+
+const std::vector<std::optional<Action>>& ActionScheduler::actions() const
+{
+    return this->_actions;
+}
+
+bool ActionScheduler::idle() const
+{
+    return this->_numInFlight == 0;
+}
+
+long ActionScheduler::_cell(unsigned int x, unsigned int y) const
+{
+    if (x >= this->_boardSize || y >= this->_boardSize)
+        return -1;
+    return static_cast<long>(y)*this->_boardSize + x;
+}
+
+bool ActionScheduler::canStart(const Event& event, const SimulationState& state) const
+{
+    if (event.type == EventType::WIN)
+        return this->idle();
+    if (event.robot >= this->_actions.size())
+        return true;
+    if (this->_actions[event.robot])
+        return false;
+    const RobotState& robot{state.robots()[event.robot]};
+    int slot{NO_SLOT};
+    if (event.type == EventType::MOVE)
+    {
+        long cell{this->_cell(event.x, event.y)};
+        if (cell >= 0 && this->_busyCells[cell] > 0)
+            return false;
+        slot = robot.emptiedSlot;
+    }
+    else if (event.type == EventType::PICKUP)
+        slot = pickupSlot(this->_boardSize, robot.x, robot.y);
+    return slot == NO_SLOT || !this->_busySlots[slot];
+}
+
+void ActionScheduler::start(const Event& event, SimulationState& state)
+{
+    if (event.type == EventType::WIN || event.robot >= this->_actions.size())
+    {
+        state.apply(event);
+        return;
+    }
+    RobotState before{state.robots()[event.robot]};
+    state.apply(event);
+    this->_start(Action{event.robot, event.type, before, state.robots()[event.robot], this->_clock});
+}
+
+void ActionScheduler::startReversed(const Event& event, const UndoRecord& record, SimulationState& state)
+{
+    if (event.type == EventType::WIN || event.robot >= this->_actions.size())
+    {
+        state.undo(event, record);
+        return;
+    }
+    RobotState after{state.robots()[event.robot]};
+    state.undo(event, record);
+    this->_start(Action{event.robot, event.type, state.robots()[event.robot], after, this->_clock, true});
+}
+
+void ActionScheduler::_start(const Action& action)
+{
+    Action started{action};
+    // a forward move turns on its cell first, a reversed one drives off at once and turns at the end
+    if (action.type == EventType::MOVE && !action.reversed)
+    {
+        // poses before the start are the starting pose, so waiting costs nothing to draw
+        long target{this->_cell(action.to.x, action.to.y)};
+        if (target >= 0)
+            started.start = std::max(started.start, this->_departures[target] - action.turnDuration());
+        long cell{this->_cell(action.from.x, action.from.y)};
+        if (cell >= 0)
+            this->_departures[cell] = std::max(this->_departures[cell], started.start + action.turnDuration());
+    }
+    this->_mark(started, true);
+    this->_ends.emplace(started.start + started.duration(), started.robot);
+    this->_actions[action.robot] = started;
+    ++this->_numInFlight;
+}
+
+std::optional<Action> ActionScheduler::finishNext(double time)
+{
+    if (this->_ends.empty() || this->_ends.top().first > time)
+        return std::nullopt;
+    auto [end, robot] = this->_ends.top();
+    this->_ends.pop();
+    // actions ending inside a step still end on time, so the next one doesn't start late
+    if (end > this->_clock)
+        this->_clock = end;
+    std::optional<Action> action{std::move(this->_actions[robot])};
+    this->_actions[robot].reset();
+    this->_mark(*action, false);
+    --this->_numInFlight;
+    return action;
+}
+
+void ActionScheduler::advanceTo(double time)
+{
+    if (time > this->_clock)
+        this->_clock = time;
+}
+
+void ActionScheduler::clear()
+{
+    for (std::optional<Action>& action : this->_actions)
+        action.reset();
+    this->_ends = {};
+    std::fill(this->_busyCells.begin(), this->_busyCells.end(), 0);
+    std::fill(this->_departures.begin(), this->_departures.end(), 0.0);
+    std::fill(this->_busySlots.begin(), this->_busySlots.end(), false);
+    this->_numInFlight = 0;
+}
+
+void ActionScheduler::_mark(const Action& action, bool busy)
+{
+    if (action.type == EventType::MOVE)
+    {
+        long cell{this->_cell(action.end().x, action.end().y)};
+        if (cell >= 0)
+            this->_busyCells[cell] += busy ? 1 : -1;
+    }
+    int slot{actionSlot(action)};
+    if (slot != NO_SLOT)
+        this->_busySlots[slot] = busy;
+}
@@ -0,0 +1,64 @@
+#ifndef SCHEDULER_H
+#define SCHEDULER_H
+#include <functional>
+#include <optional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "episode.hpp"
+#include "simulation.hpp"
+#include "animation.hpp"
+
+// keeps one in-flight action per robot so robots animate side by side.
+// events start in log order, the first one that conflicts with an in-flight action holds back the rest
+class ActionScheduler
+{
+public:
+    ActionScheduler() = default;
+    ActionScheduler(unsigned int numRobots, unsigned int boardSize);
+    // animation clock, seconds
+    double clock() const;
+    // whether event can start now: its robot is free, no other robot is heading for its target cell,
+    // no other action takes or puts back the box it needs. WIN waits for every action to end.
+    // following a robot out of its cell is fine, trains of robots move together
+    bool canStart(const Event& event, const SimulationState& state) const;
+    // apply event to state and start animating it at the current clock, WIN is applied without animation.
+    // a move into a cell whose robot is still turning before it drives off waits in place until then
+    void start(const Event& event, SimulationState& state);
+    // undo event on state and start animating it backwards. rewinding plays one event at a time,
+    // so this expects idle()
+    void startReversed(const Event& event, const UndoRecord& record, SimulationState& state);
+    // end the in-flight action finishing first if it finishes by time, the clock moves to its end
+    std::optional<Action> finishNext(double time);
+    // move the clock to time, once finishNext(time) has nothing left
+    void advanceTo(double time);
+    const std::vector<std::optional<Action>>& actions() const;
+    bool idle() const;
+    // drop every in-flight action without finishing it
+    void clear();
+private:
+    double _clock{0.0};
+    unsigned int _boardSize{0};
+    // indexed by robot
+    std::vector<std::optional<Action>> _actions;
+    // (end time, robot) of in-flight actions, earliest first
+    std::priority_queue<std::pair<double, unsigned int>, std::vector<std::pair<double, unsigned int>>, std::greater<>> _ends;
+    // in-flight moves heading for each cell, indexed y*_boardSize + x
+    std::vector<unsigned int> _busyCells;
+    // clock at which the robot turning on each cell starts driving off it, indexed like _busyCells
+    std::vector<double> _departures;
+    // whether an in-flight action takes or puts back the box of each pickup cell
+    std::vector<bool> _busySlots;
+    unsigned int _numInFlight{0};
+
+    // index into _busyCells, or -1 off the board
+    long _cell(unsigned int x, unsigned int y) const;
+    void _start(const Action& action);
+    void _mark(const Action& action, bool busy);
+};
+
+// pickup cell whose box action takes (PICKUP) or puts back (MOVE), NO_SLOT if none
+int actionSlot(const Action& action);
+
+#endif
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <algorithm>
+#include <limits>
+#include <vector>
 #include <glad/glad.h> 
 #include <glm/glm.hpp>
 #include "shader.hpp"
@@ -89,6 +92,7 @@ unsigned int setupShader(const char* vertexPath, const char* fragmentPath)
 Shader::Shader(unsigned int ID)
 : _ID{ID} 
 {
+    this->_findUniforms();
 };
 
 void Shader::use() const
@@ -99,64 +103,162 @@ void Shader::use() const
 void Shader::setID(unsigned int id)
 {
     this->_ID = id;
+    this->_findUniforms();
+}
+
+void Shader::_findUniforms()
+{
+    this->_uniforms.clear();
+    int numUniforms{0};
+    int maxLength{0};
+    glGetProgramiv(this->_ID, GL_ACTIVE_UNIFORMS, &numUniforms);
+    glGetProgramiv(this->_ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::vector<char> name(std::max(maxLength, 1));
+    for (int i=0; i<numUniforms; ++i)
+    {
+        int length, size;
+        GLenum type;
+        glGetActiveUniform(this->_ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, name.data());
+        std::string_view uniformName(name.data(), length);
+        int location{glGetUniformLocation(this->_ID, name.data())};
+        // uniforms in blocks have no location
+        if (location < 0)
+            continue;
+        this->_uniforms.emplace_back(UniformName(uniformName).hash, location);
+        // arrays are reported as "name[0]", they are set by plain name as well
+        if (uniformName.size() > 3 && uniformName.substr(uniformName.size() - 3) == "[0]")
+            this->_uniforms.emplace_back(UniformName(uniformName.substr(0, uniformName.size() - 3)).hash, location);
+    }
+    std::sort(this->_uniforms.begin(), this->_uniforms.end());
+    for (std::size_t i=1; i<this->_uniforms.size(); ++i)
+        if (this->_uniforms[i].first == this->_uniforms[i - 1].first && this->_uniforms[i].second != this->_uniforms[i - 1].second)
+            std::cout << "ERROR::SHADER::UNIFORM_NAME_COLLISION in program " << this->_ID << std::endl;
+}
+
+UniformHandle Shader::uniform(UniformName name) const
+{
+    auto found{std::lower_bound(this->_uniforms.begin(), this->_uniforms.end(), std::make_pair(name.hash, std::numeric_limits<int>::min()))};
+    if (found == this->_uniforms.end() || found->first != name.hash)
+        return UniformHandle{};
+    return UniformHandle{found->second};
 }
 
 // utility uniform functions
-void Shader::setBool(const std::string &name, bool value) const
+void Shader::setBool(UniformHandle uniform, bool value) const
 {         
-    glUniform1i(glGetUniformLocation(this->_ID, name.c_str()), (int)value); 
+    glUniform1i(uniform.location, (int)value); 
 };
 
-void Shader::setInt(const std::string &name, int value) const
+void Shader::setInt(UniformHandle uniform, int value) const
 { 
-    glUniform1i(glGetUniformLocation(this->_ID, name.c_str()), value); 
+    glUniform1i(uniform.location, value); 
 };
 
-void Shader::setFloat(const std::string &name, float value) const
+void Shader::setFloat(UniformHandle uniform, float value) const
 { 
-    glUniform1f(glGetUniformLocation(this->_ID, name.c_str()), value); 
+    glUniform1f(uniform.location, value); 
 };
-void Shader::setVec2(const std::string &name, const glm::vec2 &value) const
+void Shader::setVec2(UniformHandle uniform, const glm::vec2 &value) const
 { 
-    glUniform2fv(glGetUniformLocation(this->_ID, name.c_str()), 1, &value[0]); 
+    glUniform2fv(uniform.location, 1, &value[0]); 
 };
 
-void Shader::setVec2(const std::string &name, float x, float y) const
+void Shader::setVec2(UniformHandle uniform, float x, float y) const
 { 
-    glUniform2f(glGetUniformLocation(this->_ID, name.c_str()), x, y); 
+    glUniform2f(uniform.location, x, y); 
 };
 
-void Shader::setVec3(const std::string &name, const glm::vec3 &value) const
+void Shader::setVec3(UniformHandle uniform, const glm::vec3 &value) const
 { 
-    glUniform3fv(glGetUniformLocation(this->_ID, name.c_str()), 1, &value[0]); 
+    glUniform3fv(uniform.location, 1, &value[0]); 
 };
 
-void Shader::setVec3(const std::string &name, float x, float y, float z) const
+void Shader::setVec3(UniformHandle uniform, float x, float y, float z) const
 { 
-    glUniform3f(glGetUniformLocation(this->_ID, name.c_str()), x, y, z); 
+    glUniform3f(uniform.location, x, y, z); 
 };
 
-void Shader::setVec4(const std::string &name, const glm::vec4 &value) const
+void Shader::setVec4(UniformHandle uniform, const glm::vec4 &value) const
 { 
-    glUniform4fv(glGetUniformLocation(this->_ID, name.c_str()), 1, &value[0]); 
+    glUniform4fv(uniform.location, 1, &value[0]); 
 };
 
-void Shader::setVec4(const std::string &name, float x, float y, float z, float w) const
+void Shader::setVec4(UniformHandle uniform, float x, float y, float z, float w) const
 { 
-    glUniform4f(glGetUniformLocation(this->_ID, name.c_str()), x, y, z, w); 
+    glUniform4f(uniform.location, x, y, z, w); 
+};
+
+void Shader::setMat2(UniformHandle uniform, const glm::mat2 &mat) const
+{
+    glUniformMatrix2fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
 };
 
-void Shader::setMat2(const std::string &name, const glm::mat2 &mat) const
+void Shader::setMat3(UniformHandle uniform, const glm::mat3 &mat) const
 {
-    glUniformMatrix2fv(glGetUniformLocation(this->_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix3fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
 };
 
-void Shader::setMat3(const std::string &name, const glm::mat3 &mat) const
+void Shader::setMat4(UniformHandle uniform, const glm::mat4 &mat) const
 {
-    glUniformMatrix3fv(glGetUniformLocation(this->_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    glUniformMatrix4fv(uniform.location, 1, GL_FALSE, &mat[0][0]);
 };
 
-void Shader::setMat4(const std::string &name, const glm::mat4 &mat) const
+void Shader::setBool(UniformName name, bool value) const
+{
+    this->setBool(this->uniform(name), value);
+}
+
+void Shader::setInt(UniformName name, int value) const
+{
+    this->setInt(this->uniform(name), value);
+}
+
+void Shader::setFloat(UniformName name, float value) const
+{
+    this->setFloat(this->uniform(name), value);
+}
+
+void Shader::setVec2(UniformName name, const glm::vec2 &value) const
+{
+    this->setVec2(this->uniform(name), value);
+}
+
+void Shader::setVec2(UniformName name, float x, float y) const
 {
-    glUniformMatrix4fv(glGetUniformLocation(this->_ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
-};
\ No newline at end of file
+    this->setVec2(this->uniform(name), x, y);
+}
+
+void Shader::setVec3(UniformName name, const glm::vec3 &value) const
+{
+    this->setVec3(this->uniform(name), value);
+}
+
+void Shader::setVec3(UniformName name, float x, float y, float z) const
+{
+    this->setVec3(this->uniform(name), x, y, z);
+}
+
+void Shader::setVec4(UniformName name, const glm::vec4 &value) const
+{
+    this->setVec4(this->uniform(name), value);
+}
+
+void Shader::setVec4(UniformName name, float x, float y, float z, float w) const
+{
+    this->setVec4(this->uniform(name), x, y, z, w);
+}
+
+void Shader::setMat2(UniformName name, const glm::mat2 &mat) const
+{
+    this->setMat2(this->uniform(name), mat);
+}
+
+void Shader::setMat3(UniformName name, const glm::mat3 &mat) const
+{
+    this->setMat3(this->uniform(name), mat);
+}
+
+void Shader::setMat4(UniformName name, const glm::mat4 &mat) const
+{
+    this->setMat4(this->uniform(name), mat);
+}
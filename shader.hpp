@@ -1,11 +1,53 @@
 #ifndef SHADER_H
 #define SHADER_H
   
+#include <cstdint>
 #include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <glm/gtc/type_ptr.hpp>
 
+// a uniform named by the 32 bit FNV-1a hash of its name. constexpr, so fixed names cost nothing at run time
+struct UniformName
+{
+    constexpr UniformName(std::string_view name)
+    : hash{2166136261u}
+    {
+        for (char c : name)
+        {
+            this->hash ^= static_cast<unsigned char>(c);
+            this->hash *= 16777619u;
+        }
+    }
+    constexpr UniformName(const char* name)
+    : UniformName(std::string_view(name))
+    {
+    }
+    std::uint32_t hash;
+};
+
+// location of an active uniform of a shader. -1 if there is no such uniform, setting it then does nothing
+struct UniformHandle
+{
+    int location{-1};
+};
+
+// uniforms set every frame, projection and view are in the Camera block
+inline constexpr UniformName UNIFORM_MODEL{"model"};
+inline constexpr UniformName UNIFORM_MATERIAL_AMBIENT{"material.ambient"};
+inline constexpr UniformName UNIFORM_MATERIAL_DIFFUSE{"material.diffuse"};
+inline constexpr UniformName UNIFORM_MATERIAL_SPECULAR{"material.specular"};
+inline constexpr UniformName UNIFORM_MATERIAL_SHININESS{"material.shininess"};
+inline constexpr UniformName UNIFORM_LIGHT_AMBIENT{"light.ambient"};
+inline constexpr UniformName UNIFORM_LIGHT_DIFFUSE{"light.diffuse"};
+inline constexpr UniformName UNIFORM_LIGHT_SPECULAR{"light.specular"};
+inline constexpr UniformName UNIFORM_PLAYER_COLORED{"playerColored"};
+// samplers of a material's diffuse textures, textures past the last one are not bound
+inline constexpr UniformName UNIFORM_TEXTURE_DIFFUSE[]{"texture_diffuse1", "texture_diffuse2", "texture_diffuse3", "texture_diffuse4"};
+
 void checkCompileErrors(unsigned int shader, std::string type);
 unsigned int setupShader(const char* vertexPath, const char* fragmentPath);
 
@@ -14,26 +56,45 @@ class Shader
 public:
     // constructor reads and builds the shader
     Shader() = default;
+    // looks up the active uniforms of the linked program ID once
     explicit Shader(unsigned int ID);
     // use the shader
     void use() const;
-    // utility uniform functions
     void setID(unsigned int id);
-    void setBool(const std::string &name, bool value) const;  
-    void setInt(const std::string &name, int value) const;   
-    void setFloat(const std::string &name, float value) const;
-    void setVec2(const std::string &name, const glm::vec2 &value) const;
-    void setVec2(const std::string &name, float x, float y) const;
-    void setVec3(const std::string &name, const glm::vec3 &value) const;
-    void setVec3(const std::string &name, float x, float y, float z) const;
-    void setVec4(const std::string &name, const glm::vec4 &value) const;
-    void setVec4(const std::string &name, float x, float y, float z, float w) const;
-    void setMat2(const std::string &name, const glm::mat2 &mat) const;
-    void setMat3(const std::string &name, const glm::mat3 &mat) const;
-    void setMat4(const std::string &name, const glm::mat4 &mat) const;
+    // found in the table made at construction, no driver call
+    UniformHandle uniform(UniformName name) const;
+    // utility uniform functions
+    void setBool(UniformHandle uniform, bool value) const;  
+    void setInt(UniformHandle uniform, int value) const;   
+    void setFloat(UniformHandle uniform, float value) const;
+    void setVec2(UniformHandle uniform, const glm::vec2 &value) const;
+    void setVec2(UniformHandle uniform, float x, float y) const;
+    void setVec3(UniformHandle uniform, const glm::vec3 &value) const;
+    void setVec3(UniformHandle uniform, float x, float y, float z) const;
+    void setVec4(UniformHandle uniform, const glm::vec4 &value) const;
+    void setVec4(UniformHandle uniform, float x, float y, float z, float w) const;
+    void setMat2(UniformHandle uniform, const glm::mat2 &mat) const;
+    void setMat3(UniformHandle uniform, const glm::mat3 &mat) const;
+    void setMat4(UniformHandle uniform, const glm::mat4 &mat) const;
+    // the same by name, pass a UNIFORM_ constant or a literal
+    void setBool(UniformName name, bool value) const;  
+    void setInt(UniformName name, int value) const;   
+    void setFloat(UniformName name, float value) const;
+    void setVec2(UniformName name, const glm::vec2 &value) const;
+    void setVec2(UniformName name, float x, float y) const;
+    void setVec3(UniformName name, const glm::vec3 &value) const;
+    void setVec3(UniformName name, float x, float y, float z) const;
+    void setVec4(UniformName name, const glm::vec4 &value) const;
+    void setVec4(UniformName name, float x, float y, float z, float w) const;
+    void setMat2(UniformName name, const glm::mat2 &mat) const;
+    void setMat3(UniformName name, const glm::mat3 &mat) const;
+    void setMat4(UniformName name, const glm::mat4 &mat) const;
 private:
     // the program ID
     unsigned int _ID;
+    // name hash and location of every active uniform, sorted by hash
+    std::vector<std::pair<std::uint32_t, int>> _uniforms;
+    void _findUniforms();
 };
 
   
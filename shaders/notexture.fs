@@ -14,8 +14,18 @@ struct Light {
     vec3 specular;
 };
 
+// one color per player, written once at startup
+layout (std430, binding = 0) readonly buffer Palette {
+    vec4 playerColors[];
+};
+
 uniform Material material;
 uniform Light light;
+// whether playerColors[player] replaces material.diffuse
+uniform bool playerColored;
+
+// index into playerColors of the forklift being drawn
+flat in uint player;
 
 void main()
 {
@@ -24,7 +34,8 @@ void main()
   	
     // diffuse 
     float diff = 1.0;
-    vec3 diffuse = light.diffuse * (diff * material.diffuse);
+    vec3 materialDiffuse = playerColored ? playerColors[player].rgb : material.diffuse;
+    vec3 diffuse = light.diffuse * (diff * materialDiffuse);
     
     // specular 
     float spec = pow(1.0, material.shininess);
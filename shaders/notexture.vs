@@ -1,11 +1,26 @@
 #version 460 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+struct Forklift {
+    mat4 model;
+    uint player;
+};
+
+// one entry per forklift, each drawn as an instance
+layout (std430, binding = 1) readonly buffer Forklifts {
+    Forklift forklifts[];
+};
+
+// shared by every shader, see Camera
+layout (std140, binding = 0) uniform Camera {
+    mat4 projection;
+    mat4 view;
+};
+
+flat out uint player;
 
 void main()
 {  
-    gl_Position = projection * view * model * vec4(aPos, 1.0);
+    player = forklifts[gl_InstanceID].player;
+    gl_Position = projection * view * forklifts[gl_InstanceID].model * vec4(aPos, 1.0);
 }
\ No newline at end of file
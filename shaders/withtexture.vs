@@ -4,9 +4,13 @@ layout (location = 2) in vec2 aTexCoords;
 
 out vec2 TexCoords;
 
+// shared by every shader, see Camera
+layout (std140, binding = 0) uniform Camera {
+    mat4 projection;
+    mat4 view;
+};
+
 uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
 
 void main()
 {
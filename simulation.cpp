@@ -0,0 +1,167 @@
+#include <vector>
+
+#include "simulation.hpp"
+
+unsigned int numPickupCells(unsigned int boardSize)
+{
+    return boardSize < 5 ? 0 : (boardSize - 5)/2 + 1;
+}
+
+std::pair<unsigned int, unsigned int> pickupCell(unsigned int boardSize, unsigned int slot)
+{
+    return {2 + 2*slot, boardSize - 2};
+}
+
+int pickupSlot(unsigned int boardSize, unsigned int x, unsigned int y)
+{
+    if (y + 2 != boardSize || x < 2 || x % 2 != 0 || (x - 2)/2 >= numPickupCells(boardSize))
+        return NO_SLOT;
+    return static_cast<int>((x - 2)/2);
+}
+
+SimulationState::SimulationState(const Episode& episode)
+: _boardSize{episode.boardSize}
+, _boxSpawned(numPickupCells(episode.boardSize), true)
+{
+    this->_robots.reserve(episode.initialPositions.size());
+    for (const RobotPosition& position : episode.initialPositions)
+        this->_robots.push_back(RobotState{position.x, position.y});
+}
+
+const char* SimulationState::check(const Event& event) const
+{
+    if (event.type == EventType::WIN)
+        return nullptr;
+    if (event.robot >= this->_robots.size())
+        return "unknown robot";
+    const RobotState& robot{this->_robots[event.robot]};
+    switch (event.type)
+    {
+        case EventType::MOVE:
+        {
+            unsigned int x{robot.x};
+            unsigned int y{robot.y};
+            switch (event.direction)
+            {
+                case Orientation::UP:
+                    --y;
+                    break;
+                case Orientation::DOWN:
+                    ++y;
+                    break;
+                case Orientation::LEFT:
+                    --x;
+                    break;
+                case Orientation::RIGHT:
+                    ++x;
+                    break;
+            }
+            if (event.x != x || event.y != y)
+                return "target is not the next cell in the move direction";
+            break;
+        }
+        case EventType::PICKUP:
+            if (robot.mail != NO_MAIL)
+                return "pick up while carrying mail";
+            break;
+        case EventType::DROPOFF:
+            if (robot.mail != event.mail)
+                return "drop off of mail the robot doesn't carry";
+            break;
+        case EventType::WIN:
+            break;
+    }
+    return nullptr;
+}
+
+void SimulationState::apply(const Event& event)
+{
+    if (event.type == EventType::WIN)
+    {
+        this->_winner = event.robot;
+        return;
+    }
+    RobotState& robot{this->_robots[event.robot]};
+    switch (event.type)
+    {
+        case EventType::MOVE:
+            // a new box appears once the robot that took the last one leaves
+            if (robot.emptiedSlot != NO_SLOT)
+            {
+                this->_boxSpawned[robot.emptiedSlot] = true;
+                robot.emptiedSlot = NO_SLOT;
+            }
+            robot.orient = event.direction;
+            robot.x = event.x;
+            robot.y = event.y;
+            break;
+        case EventType::PICKUP:
+            // boxes are taken facing the camera
+            robot.orient = Orientation::DOWN;
+            robot.mail = event.mail;
+            robot.emptiedSlot = pickupSlot(this->_boardSize, robot.x, robot.y);
+            if (robot.emptiedSlot != NO_SLOT)
+                this->_boxSpawned[robot.emptiedSlot] = false;
+            break;
+        case EventType::DROPOFF:
+            robot.mail = NO_MAIL;
+            break;
+        case EventType::WIN:
+            break;
+    }
+}
+
+UndoRecord SimulationState::undoRecord(const Event& event) const
+{
+    if (event.type == EventType::WIN)
+        return UndoRecord{RobotState{0, 0}, false, this->_winner};
+    const RobotState& robot{this->_robots[event.robot]};
+    int slot{pickupSlot(this->_boardSize, robot.x, robot.y)};
+    return UndoRecord{robot, slot != NO_SLOT && this->_boxSpawned[slot], this->_winner};
+}
+
+void SimulationState::undo(const Event& event, const UndoRecord& record)
+{
+    if (event.type == EventType::WIN)
+    {
+        this->_winner = record.winner;
+        return;
+    }
+    RobotState& robot{this->_robots[event.robot]};
+    switch (event.type)
+    {
+        case EventType::MOVE:
+            // the box put back when the robot left is gone again
+            if (record.robot.emptiedSlot != NO_SLOT)
+                this->_boxSpawned[record.robot.emptiedSlot] = false;
+            break;
+        case EventType::PICKUP:
+            if (robot.emptiedSlot != NO_SLOT)
+                this->_boxSpawned[robot.emptiedSlot] = record.boxSpawned;
+            break;
+        case EventType::DROPOFF:
+        case EventType::WIN:
+            break;
+    }
+    robot = record.robot;
+}
+
+const std::vector<RobotState>& SimulationState::robots() const
+{
+    return this->_robots;
+}
+
+unsigned int SimulationState::boardSize() const
+{
+    return this->_boardSize;
+}
+
+bool SimulationState::boxSpawned(unsigned int slot) const
+{
+    return this->_boxSpawned[slot];
+}
+
+int SimulationState::winner() const
+{
+    return this->_winner;
+}
@@ -0,0 +1,66 @@
+#ifndef SIMULATION_H
+#define SIMULATION_H
+#include <utility>
+#include <vector>
+
+#include "orientation.hpp"
+#include "episode.hpp"
+
+inline constexpr int NO_MAIL{-1};
+inline constexpr int NO_SLOT{-1};
+
+// boxes wait on every other cell of the second to last row, starting two cells in from either side.
+// slots count left to right as seen by the camera, on the 9x9 board they are (2,7), (4,7), (6,7)
+unsigned int numPickupCells(unsigned int boardSize);
+std::pair<unsigned int, unsigned int> pickupCell(unsigned int boardSize, unsigned int slot);
+// slot of the pickup cell at (x, y), or NO_SLOT if it is not one
+int pickupSlot(unsigned int boardSize, unsigned int x, unsigned int y);
+
+struct RobotState
+{
+    unsigned int x;
+    unsigned int y;
+    Orientation orient{Orientation::DOWN};
+    // id of the carried mail
+    int mail{NO_MAIL};
+    // pickup cell this robot took a box from, refilled when it moves away
+    int emptiedSlot{NO_SLOT};
+};
+
+// what apply overwrites, so an event can be undone without replaying from a snapshot
+struct UndoRecord
+{
+    // the event's robot before the event
+    RobotState robot;
+    // whether a box was waiting on the robot's cell, for PICKUP
+    bool boxSpawned{false};
+    int winner{-1};
+};
+
+// logical board state, advanced one event at a time by the same rules the viewer animates
+class SimulationState
+{
+public:
+    SimulationState() = default;
+    explicit SimulationState(const Episode& episode);
+    // why event can't follow this state, nullptr if it can
+    const char* check(const Event& event) const;
+    void apply(const Event& event);
+    // record to take before apply(event)
+    UndoRecord undoRecord(const Event& event) const;
+    // inverse of apply(event), the state must be the one apply left
+    void undo(const Event& event, const UndoRecord& record);
+    const std::vector<RobotState>& robots() const;
+    unsigned int boardSize() const;
+    bool boxSpawned(unsigned int slot) const;
+    // index of the winning player, -1 while the game is running
+    int winner() const;
+private:
+    std::vector<RobotState> _robots;
+    unsigned int _boardSize{BOARD_SIZE};
+    // indexed by pickup slot
+    std::vector<bool> _boxSpawned;
+    int _winner{-1};
+};
+
+#endif
@@ -0,0 +1,49 @@
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// lock-free ring for exactly one producer thread and one consumer thread
+template <typename T, std::size_t Capacity>
+class SpscQueue
+{
+    static_assert((Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+public:
+    // called by the producer only, false if the ring is full
+    bool push(const T& value)
+    {
+        std::size_t tail{this->_tail.load(std::memory_order_relaxed)};
+        if (tail - this->_head.load(std::memory_order_acquire) == Capacity)
+            return false;
+        this->_buffer[tail & (Capacity - 1)] = value;
+        this->_tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+    // called by the consumer only, false if the ring is empty
+    bool pop(T& value)
+    {
+        std::size_t head{this->_head.load(std::memory_order_relaxed)};
+        if (head == this->_tail.load(std::memory_order_acquire))
+            return false;
+        value = this->_buffer[head & (Capacity - 1)];
+        this->_head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+    // called by the producer only
+    bool full() const
+    {
+        return this->_tail.load(std::memory_order_relaxed) - this->_head.load(std::memory_order_acquire) == Capacity;
+    }
+    bool empty() const
+    {
+        return this->_head.load(std::memory_order_acquire) == this->_tail.load(std::memory_order_acquire);
+    }
+private:
+    std::array<T, Capacity> _buffer;
+    // keep the two indices on separate cache lines so the threads don't fight over one
+    alignas(64) std::atomic<std::size_t> _head{0};
+    alignas(64) std::atomic<std::size_t> _tail{0};
+};
+
+#endif
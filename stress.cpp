@@ -0,0 +1,152 @@
+#include <iostream>
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "episode.hpp"
+#include "mappedfile.hpp"
+#include "simulation.hpp"
+#include "scheduler.hpp"
+
+// seconds since start
+double since(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// PLAYERS, then letters for bigger games
+inline constexpr std::string_view LETTERS{"RBGCMYWKOPTV"};
+
+void appendLine(std::string& log, unsigned int tick, const std::string& message)
+{
+    log += "INFO: At t=" + std::to_string(tick) + "     " + message + "\n";
+}
+
+// a log of random walks by robotsPerPlayer robots of numPlayers players on a boardSize board.
+// robots never share a cell, they pick up mail on pickup cells and drop it a few moves later
+std::string generateLog(unsigned int robotsPerPlayer, unsigned int numPlayers, unsigned int boardSize, unsigned int ticks)
+{
+    unsigned int numRobots{robotsPerPlayer*numPlayers};
+    std::string log;
+    appendLine(log, 0, "game starts with " + std::to_string(robotsPerPlayer) + " number robots per player and " + std::to_string(numPlayers) + " players");
+    std::vector<bool> occupied(boardSize*boardSize, false);
+    std::vector<std::pair<unsigned int, unsigned int>> cells(numRobots);
+    std::vector<int> mail(numRobots, NO_MAIL);
+    std::vector<std::string> names(numRobots);
+    for (unsigned int robot=0; robot<numRobots; ++robot)
+    {
+        // spread robots over every other cell so they have room to move
+        unsigned int cell{(robot*2) % (boardSize*boardSize)};
+        while (occupied[cell])
+            cell = (cell + 1) % (boardSize*boardSize);
+        occupied[cell] = true;
+        cells[robot] = {cell % boardSize, cell / boardSize};
+        names[robot] = std::string{LETTERS[robot / robotsPerPlayer]} + " robot " + std::to_string(robot % robotsPerPlayer + 1);
+        appendLine(log, 0, names[robot] + " in position [" + std::to_string(cells[robot].first) + "," + std::to_string(cells[robot].second) + "]");
+    }
+    constexpr const char* DIRECTIONS[4]{"up", "down", "left", "right"};
+    constexpr int DX[4]{0, 0, -1, 1};
+    constexpr int DY[4]{-1, 1, 0, 0};
+    std::mt19937 random{42};
+    unsigned int nextMail{0};
+    for (unsigned int tick=1; tick<=ticks; ++tick)
+    {
+        for (unsigned int robot=0; robot<numRobots; ++robot)
+        {
+            auto [x, y] = cells[robot];
+            if (mail[robot] == NO_MAIL && pickupSlot(boardSize, x, y) != NO_SLOT)
+            {
+                mail[robot] = static_cast<int>(nextMail++ % 65536);
+                appendLine(log, tick, names[robot] + " pick up mail " + std::to_string(mail[robot]));
+                continue;
+            }
+            if (mail[robot] != NO_MAIL && random() % 8 == 0)
+            {
+                appendLine(log, tick, names[robot] + " drop off mail " + std::to_string(mail[robot]));
+                mail[robot] = NO_MAIL;
+                continue;
+            }
+            unsigned int direction{static_cast<unsigned int>(random() % 4)};
+            long nx{static_cast<long>(x) + DX[direction]};
+            long ny{static_cast<long>(y) + DY[direction]};
+            if (nx < 0 || ny < 0 || nx >= boardSize || ny >= boardSize || occupied[ny*boardSize + nx])
+                continue;
+            occupied[y*boardSize + x] = false;
+            occupied[ny*boardSize + nx] = true;
+            cells[robot] = {static_cast<unsigned int>(nx), static_cast<unsigned int>(ny)};
+            appendLine(log, tick, names[robot] + " go " + DIRECTIONS[direction] + " to position (" + std::to_string(nx) + "," + std::to_string(ny) + ")");
+        }
+    }
+    appendLine(log, ticks, "Player r win");
+    return log;
+}
+
+void stress(unsigned int robotsPerPlayer, unsigned int numPlayers, unsigned int boardSize, unsigned int ticks)
+{
+    auto start{std::chrono::steady_clock::now()};
+    std::string log{generateLog(robotsPerPlayer, numPlayers, boardSize, ticks)};
+    std::cout << "generated: " << log.size() / (1024.0*1024.0) << " MB in " << since(start) << " s\n";
+
+    start = std::chrono::steady_clock::now();
+    Episode episode;
+    forEachLine(log, [&episode](std::string_view line) {
+        parseLogLine(line, episode);
+    });
+    double parseTime{since(start)};
+    std::size_t numEvents{episode.events.size()};
+    std::cout << "robots:    " << episode.initialPositions.size() << " of players " << episode.players << " on a " << episode.boardSize << "x" << episode.boardSize << " board, "
+        << numPickupCells(episode.boardSize) << " pickup cells\n";
+    // parsed like the viewer does, from what the log shows of the board
+    if (episode.boardSize != boardSize)
+        std::cout << "           generated on a " << boardSize << "x" << boardSize << " board\n";
+    std::cout << "parse:     " << numEvents << " events, " << numEvents / parseTime / 1e6 << " M events/s\n";
+
+    start = std::chrono::steady_clock::now();
+    SimulationState state{episode};
+    std::size_t rejected{0};
+    for (const Event& event : episode.events)
+    {
+        if (state.check(event))
+            ++rejected;
+        state.apply(event);
+    }
+    double simulateTime{since(start)};
+    std::cout << "simulate:  " << numEvents / simulateTime / 1e6 << " M events/s, " << rejected << " rejected\n";
+
+    // everything Game::run does per event except drawing
+    start = std::chrono::steady_clock::now();
+    SimulationState played{episode};
+    ActionScheduler scheduler{static_cast<unsigned int>(episode.initialPositions.size()), episode.boardSize};
+    std::size_t nextEvent{0};
+    auto dispatch{[&]() {
+        while (nextEvent < numEvents && scheduler.canStart(episode.events[nextEvent], played))
+            scheduler.start(episode.events[nextEvent++], played);
+    }};
+    while (nextEvent < numEvents || !scheduler.idle())
+    {
+        double time{scheduler.clock() + SIMULATION_TIMESTEP};
+        dispatch();
+        while (scheduler.finishNext(time))
+            dispatch();
+        scheduler.advanceTo(time);
+    }
+    double scheduleTime{since(start)};
+    std::cout << "schedule:  " << numEvents / scheduleTime / 1e6 << " M events/s, "
+        << scheduler.clock() << " s of animation for " << ticks << " ticks\n";
+}
+
+int main(int argc, char** argv)
+{
+    unsigned int robotsPerPlayer{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 1000u};
+    unsigned int boardSize{argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : 96u};
+    unsigned int ticks{argc > 3 ? static_cast<unsigned int>(std::stoul(argv[3])) : 100u};
+    unsigned int numPlayers{argc > 4 ? static_cast<unsigned int>(std::stoul(argv[4])) : 3u};
+    if (robotsPerPlayer == 0 || numPlayers == 0 || numPlayers > LETTERS.size() || robotsPerPlayer*numPlayers > boardSize*boardSize || boardSize > 255)
+    {
+        std::cerr << "Usage: " << argv[0] << " [robots per player] [board size <= 255] [ticks] [players <= " << LETTERS.size() << "]\n";
+        return 1;
+    }
+    stress(robotsPerPlayer, numPlayers, boardSize, ticks);
+    return 0;
+}
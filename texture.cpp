@@ -0,0 +1,113 @@
+#include <string>
+#include <iostream>
+#include <filesystem>
+#include <unordered_map>
+#include <glad/glad.h>
+
+#include "stb_image.h"
+#include "texture.hpp"
+
+namespace
+{
+
+struct TextureEntry
+{
+    std::string path;
+    unsigned int references;
+};
+
+// textures by resolved path, and the other way round for releasing
+std::unordered_map<std::string, unsigned int> texturesByPath;
+std::unordered_map<unsigned int, TextureEntry> textureEntries;
+TextureStats stats{0, 0, 0};
+
+}
+
+void ImageDeleter::operator()(unsigned char* pixels) const
+{
+    stbi_image_free(pixels);
+}
+
+Image decodeImage(const std::string& file)
+{
+    Image image;
+    image.pixels.reset(stbi_load(file.c_str(), &image.width, &image.height, &image.components, 0));
+    return image;
+}
+
+unsigned int uploadTexture(const Image& image, const std::string& file)
+{
+    unsigned int textureID;
+    glGenTextures(1, &textureID);
+
+    if (image.pixels)
+    {
+        GLenum format;
+        if (image.components == 1)
+            format = GL_RED;
+        else if (image.components == 3)
+            format = GL_RGB;
+        else if (image.components == 4)
+            format = GL_RGBA;
+
+        glBindTexture(GL_TEXTURE_2D, textureID);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, image.pixels.get());
+        glGenerateMipmap(GL_TEXTURE_2D);
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    }
+    else
+        std::cout << "Texture failed to load at path: " << file << std::endl;
+
+    return textureID;
+};
+
+unsigned int textureFromFile(const char *path, const std::string& directory)
+{
+    std::string file{directory + '/' + path};
+    return uploadTexture(decodeImage(file), file);
+};
+
+std::string texturePath(const char *path, const std::string &directory)
+{
+    std::error_code error;
+    std::filesystem::path resolved{std::filesystem::weakly_canonical(std::filesystem::path(directory) / path, error)};
+    return error ? directory + '/' + path : resolved.string();
+}
+
+unsigned int acquireTexture(const char *path, const std::string &directory, const Image* decoded)
+{
+    std::string key{texturePath(path, directory)};
+    auto found{texturesByPath.find(key)};
+    if (found != texturesByPath.end())
+    {
+        ++stats.hits;
+        ++textureEntries[found->second].references;
+        return found->second;
+    }
+    ++stats.misses;
+    unsigned int texture{decoded ? uploadTexture(*decoded, key) : textureFromFile(path, directory)};
+    texturesByPath.emplace(key, texture);
+    textureEntries.emplace(texture, TextureEntry{key, 1});
+    stats.live = textureEntries.size();
+    return texture;
+}
+
+void releaseTexture(unsigned int texture)
+{
+    auto found{textureEntries.find(texture)};
+    if (found == textureEntries.end() || --found->second.references > 0)
+        return;
+    glDeleteTextures(1, &texture);
+    texturesByPath.erase(found->second.path);
+    textureEntries.erase(found);
+    stats.live = textureEntries.size();
+}
+
+TextureStats textureStats()
+{
+    return stats;
+}
@@ -0,0 +1,48 @@
+#ifndef TEXTURE_H
+#define TEXTURE_H
+#include <cstddef>
+#include <memory>
+#include <string>
+
+struct TextureStats
+{
+    // acquires served by a texture already uploaded
+    unsigned int hits;
+    // acquires that had to decode and upload
+    unsigned int misses;
+    // textures currently held
+    std::size_t live;
+};
+
+struct ImageDeleter
+{
+    void operator()(unsigned char* pixels) const;
+};
+
+// pixels of an image file, decoded but not uploaded
+struct Image
+{
+    int width{0};
+    int height{0};
+    int components{0};
+    // null if the file couldn't be decoded
+    std::unique_ptr<unsigned char, ImageDeleter> pixels;
+};
+
+// read and decode file, touches no GL state so it can run on any thread
+Image decodeImage(const std::string& file);
+// upload image as a new texture, file is only used to report an image that failed to decode
+unsigned int uploadTexture(const Image& image, const std::string& file);
+// decode the image at directory/path and upload it, every call makes a new texture
+unsigned int textureFromFile(const char *path, const std::string &directory);
+// the resolved path of directory/path, which the registry keys textures by
+std::string texturePath(const char *path, const std::string &directory);
+// texture of the image at directory/path, shared by everyone holding it. keyed by the resolved path,
+// so the same file reached through different relative paths is only decoded once.
+// a miss uploads decoded when it is given instead of reading the file
+unsigned int acquireTexture(const char *path, const std::string &directory, const Image* decoded = nullptr);
+// drop one hold on texture, it is deleted when the last one goes
+void releaseTexture(unsigned int texture);
+TextureStats textureStats();
+
+#endif
@@ -0,0 +1,44 @@
+#include <algorithm>
+#include <vector>
+
+#include "timeline.hpp"
+
+Timeline::Timeline(const Episode& episode, std::size_t interval)
+: _episode{&episode}
+, _interval{interval}
+, _head{episode}
+{
+    this->_snapshots.reserve(episode.events.size() / interval + 1);
+    this->_snapshots.push_back(this->_head);
+    this->update();
+}
+
+void Timeline::update()
+{
+    const std::vector<Event>& events{this->_episode->events};
+    for (; this->_numIndexed < events.size(); ++this->_numIndexed)
+    {
+        this->_head.apply(events[this->_numIndexed]);
+        if ((this->_numIndexed + 1) % this->_interval == 0)
+            this->_snapshots.push_back(this->_head);
+    }
+}
+
+std::size_t Timeline::eventIndexAt(unsigned int tick) const
+{
+    const std::vector<Event>& events{this->_episode->events};
+    auto it{std::lower_bound(events.begin(), events.end(), tick, [](const Event& event, unsigned int t) {
+        return event.tick < t;
+    })};
+    return static_cast<std::size_t>(it - events.begin());
+}
+
+SimulationState Timeline::stateAt(std::size_t eventIndex) const
+{
+    eventIndex = std::min(eventIndex, this->_numIndexed);
+    std::size_t snapshot{eventIndex / this->_interval};
+    SimulationState state{this->_snapshots[snapshot]};
+    for (std::size_t i=snapshot*this->_interval; i<eventIndex; ++i)
+        state.apply(this->_episode->events[i]);
+    return state;
+}
@@ -0,0 +1,34 @@
+#ifndef TIMELINE_H
+#define TIMELINE_H
+#include <cstddef>
+#include <vector>
+
+#include "episode.hpp"
+#include "simulation.hpp"
+
+// events replayed on top of a snapshot when seeking, bounds the work of every seek
+inline constexpr std::size_t SNAPSHOT_INTERVAL{1024};
+
+// full states taken every SNAPSHOT_INTERVAL events of an episode
+class Timeline
+{
+public:
+    Timeline() = default;
+    explicit Timeline(const Episode& episode, std::size_t interval = SNAPSHOT_INTERVAL);
+    // index events appended to the episode since the last call
+    void update();
+    // index of the first event at or after tick, found by binary search
+    std::size_t eventIndexAt(unsigned int tick) const;
+    // state after the first eventIndex events
+    SimulationState stateAt(std::size_t eventIndex) const;
+private:
+    const Episode* _episode{nullptr};
+    std::size_t _interval{SNAPSHOT_INTERVAL};
+    // _snapshots[i] is the state after i*_interval events
+    std::vector<SimulationState> _snapshots;
+    // state after the _numIndexed events indexed so far
+    SimulationState _head;
+    std::size_t _numIndexed{0};
+};
+
+#endif